@@ -0,0 +1,841 @@
+/**
+ *     SearchServer.
+ *
+ *         .cpp  search-server,
+ *  main.cpp.      seed,    
+ *     .
+ *
+ *  ( ):
+ *  --docs=N              (  10000)
+ *  --doc-words=N          (70)
+ *  --dictionary=N        (1000)
+ *  --word-length=N        (10)
+ *  --queries=N           (100)
+ *  --query-words=N        (70)
+ *  --minus-prob=P       -   (0.1)
+ *  --zipf=S              ; 0 -   (1.0)
+ *  --seed=N            seed  (5489)
+ *  --output=FILE            JSON (  stdout)
+ *  --baseline=FILE         
+ *  --tolerance=P            baseline (0.1)
+ *  --perf=0|1             perf_event_open (1)
+ *  --calibrate=0|1       auto_execution   (0)
+ *  --positions=0|1            (0)
+ *  --shard-worker=PATH    (shard/shard.cpp)   
+ *                        ;     
+ *
+ *    baseline     1,     
+ *   .
+ *
+ *   (, ,  L1D  LLC,   )
+ *             .
+ *      ,   par-    .
+ *   ,     .
+ *
+ *    operator new      
+ *     (  ).
+ */
+
+#include "../search_server.h"
+#include "../sharded_search_server.h"
+#include "../shard_coordinator.h"
+#include "../shard_worker.h"
+#include "../network_server.h"
+#include "../process_queries.h"
+#include "../remove_duplicates.h"
+#include "../corpus_generator.h"
+#include "../latency_histogram.h"
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <execution>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//  operator new / delete     :  GCC   
+// malloc  free         
+#if defined(__GNUC__)
+#define BENCHMARK_NOINLINE __attribute__((noinline))
+#else
+#define BENCHMARK_NOINLINE
+#endif
+
+//   operator new       
+static atomic<uint64_t> allocations_count{ 0 };
+
+BENCHMARK_NOINLINE void* operator new(size_t size) {
+    allocations_count.fetch_add(1, memory_order_relaxed);
+    if (void* ptr = malloc(size > 0 ? size : 1))
+    {
+        return ptr;
+    }
+    throw bad_alloc();
+}
+
+BENCHMARK_NOINLINE void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+BENCHMARK_NOINLINE void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+struct BenchmarkConfig {
+    int documents_count = 10'000;
+    int document_words = 70;
+    int dictionary_size = 1000;
+    int max_word_length = 10;
+    int queries_count = 100;
+    int query_words = 70;
+    double minus_prob = 0.1;
+    double zipf_exponent = 1.;
+    unsigned seed = mt19937::default_seed;
+    string output_file;
+    string baseline_file;
+    double tolerance = 0.1;
+    bool perf_counters = true;
+    bool calibrate = false;
+    bool positions = false;
+    string shard_worker;
+};
+
+struct BenchmarkResult {
+    string name;
+    //   
+    uint64_t operations = 0;
+    //    (, )
+    uint64_t items = 0;
+    //   (  )
+    uint64_t postings = 0;
+    //     
+    uint64_t allocations = 0;
+    double seconds = 0.;
+    LatencyHistogram latencies;
+    PerfCounterValues counters;
+
+    double GetItemsPerSecond() const {
+        return seconds > 0. ? items / seconds : 0.;
+    }
+};
+
+//       ; 0,  
+static long GetPeakRssKb() {
+#if defined(__unix__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#elif defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+#else
+    return 0;
+#endif
+}
+
+//  operation(i)  i  [0, operations_count),   
+//  ,   ,    
+template <typename Operation>
+BenchmarkResult Measure(const string& name, size_t operations_count, size_t items_per_operation,
+    PerfCounters* perf_counters, Operation operation) {
+    using Clock = chrono::steady_clock;
+
+    BenchmarkResult result;
+    result.name = name;
+    //    ,      
+    //      ,    
+    vector<Clock::duration> latencies;
+    latencies.reserve(operations_count);
+    if (perf_counters)
+    {
+        perf_counters->Start();
+    }
+    const uint64_t allocations_start = allocations_count.load(memory_order_relaxed);
+    const auto total_start = Clock::now();
+    for (size_t i = 0; i < operations_count; ++i) {
+        const auto start = Clock::now();
+        operation(i);
+        latencies.push_back(Clock::now() - start);
+    }
+    result.seconds = chrono::duration<double>(Clock::now() - total_start).count();
+    result.allocations = allocations_count.load(memory_order_relaxed) - allocations_start;
+    if (perf_counters)
+    {
+        result.counters = perf_counters->Stop();
+    }
+    for (const auto latency : latencies) {
+        result.latencies.Record(latency);
+    }
+    result.operations = operations_count;
+    result.items = operations_count * items_per_operation;
+    return result;
+}
+
+static BenchmarkConfig ParseArguments(int argc, char* argv[]) {
+    BenchmarkConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const string argument = argv[i];
+        const auto eq = argument.find('=');
+        if (argument.rfind("--", 0) != 0 || eq == string::npos)
+        {
+            throw invalid_argument("Unexpected argument "s + argument);
+        }
+        const string key = argument.substr(2, eq - 2);
+        const string value = argument.substr(eq + 1);
+
+        if (key == "docs") config.documents_count = stoi(value);
+        else if (key == "doc-words") config.document_words = stoi(value);
+        else if (key == "dictionary") config.dictionary_size = stoi(value);
+        else if (key == "word-length") config.max_word_length = stoi(value);
+        else if (key == "queries") config.queries_count = stoi(value);
+        else if (key == "query-words") config.query_words = stoi(value);
+        else if (key == "minus-prob") config.minus_prob = stod(value);
+        else if (key == "zipf") config.zipf_exponent = stod(value);
+        else if (key == "seed") config.seed = static_cast<unsigned>(stoul(value));
+        else if (key == "output") config.output_file = value;
+        else if (key == "baseline") config.baseline_file = value;
+        else if (key == "tolerance") config.tolerance = stod(value);
+        else if (key == "perf") config.perf_counters = stoi(value) != 0;
+        else if (key == "calibrate") config.calibrate = stoi(value) != 0;
+        else if (key == "positions") config.positions = stoi(value) != 0;
+        else if (key == "shard-worker") config.shard_worker = value;
+        else throw invalid_argument("Unknown option --"s + key);
+    }
+    return config;
+}
+
+//    ,   
+struct Corpus {
+    vector<string> documents;
+    vector<string> queries;
+};
+
+static Corpus GenerateCorpus(const BenchmarkConfig& config) {
+    mt19937 generator(config.seed);
+    auto dictionary = GenerateDictionary(generator, config.dictionary_size, config.max_word_length);
+    //  ,   ,        
+    shuffle(dictionary.begin(), dictionary.end(), generator);
+
+    Corpus corpus;
+    if (config.zipf_exponent > 0.)
+    {
+        const ZipfDistribution distribution(dictionary.size(), config.zipf_exponent);
+        corpus.documents = GenerateZipfQueries(generator, dictionary, distribution, config.documents_count, config.document_words);
+        corpus.queries = GenerateZipfQueries(generator, dictionary, distribution, config.queries_count, config.query_words, config.minus_prob);
+    }
+    else
+    {
+        corpus.documents = GenerateQueries(generator, dictionary, config.documents_count, config.document_words);
+        corpus.queries.reserve(config.queries_count);
+        for (int i = 0; i < config.queries_count; ++i) {
+            corpus.queries.push_back(GenerateQuery(generator, dictionary, config.query_words, config.minus_prob));
+        }
+    }
+    return corpus;
+}
+
+//        (-  -)
+//   ,    ,      
+static uint64_t CountQueriesPostings(const Corpus& corpus) {
+    unordered_map<string_view, uint64_t> documents_freqs;
+    vector<string_view> words;
+    for (const string& document : corpus.documents) {
+        const WordRange document_words = SplitIntoWords(document);
+        words.assign(document_words.begin(), document_words.end());
+        sort(words.begin(), words.end());
+        words.erase(unique(words.begin(), words.end()), words.end());
+        for (const string_view word : words) {
+            ++documents_freqs[word];
+        }
+    }
+
+    uint64_t postings = 0;
+    for (const string& query : corpus.queries) {
+        words.clear();
+        for (string_view word : SplitIntoWords(query)) {
+            if (word[0] == '-')
+            {
+                word.remove_prefix(1);
+            }
+            words.push_back(word);
+        }
+        sort(words.begin(), words.end());
+        words.erase(unique(words.begin(), words.end()), words.end());
+        for (const string_view word : words) {
+            const auto it = documents_freqs.find(word);
+            postings += it == documents_freqs.end() ? 0 : it->second;
+        }
+    }
+    return postings;
+}
+
+static void FillServer(SearchServer& search_server, const vector<string>& documents) {
+    for (size_t i = 0; i < documents.size(); ++i) {
+        search_server.AddDocument(static_cast<int>(i), documents[i], DocumentStatus::ACTUAL, { 1, 2, 3 });
+    }
+}
+
+static vector<BenchmarkResult> RunBenchmarks(const BenchmarkConfig& config, const Corpus& corpus, PerfCounters* perf_counters) {
+    vector<BenchmarkResult> results;
+    const auto& documents = corpus.documents;
+    const auto& queries = corpus.queries;
+    const uint64_t queries_postings = CountQueriesPostings(corpus);
+
+    SearchServer search_server;
+    search_server.SetPositionalIndex(config.positions);
+    //    -  1  33,     
+    results.push_back(Measure("AddDocument"s, documents.size(), 1, perf_counters, [&](size_t i) {
+        search_server.AddDocument(static_cast<int>(i), documents[i], DocumentStatus::ACTUAL, { 1, 2, static_cast<int>(i % 97) });
+        }));
+
+    //       
+    double checksum = 0.;
+
+    results.push_back(Measure("FindTopDocuments/seq"s, queries.size(), 1, perf_counters, [&](size_t i) {
+        for (const Document& document : search_server.FindTopDocuments(execution::seq, queries[i])) {
+            checksum += document.relevance;
+        }
+        }));
+    results.back().postings = queries_postings;
+
+    //        ;      
+    vector<Document> found_documents;
+    for (const string& query : queries) {
+        search_server.FindTopDocuments(query, found_documents);
+    }
+    results.push_back(Measure("FindTopDocuments/buffer"s, queries.size(), 1, perf_counters, [&](size_t i) {
+        search_server.FindTopDocuments(queries[i], found_documents);
+        for (const Document& document : found_documents) {
+            checksum += document.relevance;
+        }
+        }));
+    results.back().postings = queries_postings;
+
+    results.push_back(Measure("FindTopDocuments/par"s, queries.size(), 1, perf_counters, [&](size_t i) {
+        for (const Document& document : search_server.FindTopDocuments(execution::par, queries[i])) {
+            checksum += document.relevance;
+        }
+        }));
+    results.back().postings = queries_postings;
+
+    results.push_back(Measure("FindTopDocuments/bm25"s, queries.size(), 1, perf_counters, [&](size_t i) {
+        for (const Document& document : search_server.FindTopDocuments(execution::seq, queries[i], DocumentStatus::ACTUAL, Bm25Scoring())) {
+            checksum += document.relevance;
+        }
+        }));
+    results.back().postings = queries_postings;
+
+    //  :   ,      '*'
+    vector<string> prefix_queries;
+    prefix_queries.reserve(queries.size());
+    for (const string& query : queries) {
+        string prefix_query;
+        size_t words_count = 0;
+        for (const string_view word : SplitIntoWords(query)) {
+            if (words_count++ == 4)
+            {
+                break;
+            }
+            prefix_query += string(word.substr(0, 3)) + "* "s;
+        }
+        prefix_queries.push_back(move(prefix_query));
+    }
+    results.push_back(Measure("FindTopDocuments/prefix"s, prefix_queries.size(), 1, perf_counters, [&](size_t i) {
+        for (const Document& document : search_server.FindTopDocuments(execution::seq, prefix_queries[i])) {
+            checksum += document.relevance;
+        }
+        }));
+
+    //   :         '_'
+    vector<string> fuzzy_queries;
+    fuzzy_queries.reserve(queries.size());
+    for (const string& query : queries) {
+        string fuzzy_query;
+        size_t words_count = 0;
+        for (const string_view word : SplitIntoWords(query)) {
+            if (words_count++ == 4)
+            {
+                break;
+            }
+            fuzzy_query += string(word.substr(0, word.size() - 1)) + "_ "s;
+        }
+        fuzzy_queries.push_back(move(fuzzy_query));
+    }
+    search_server.SetFuzzyMatching({ 2 });
+    results.push_back(Measure("FindTopDocuments/fuzzy"s, fuzzy_queries.size(), 1, perf_counters, [&](size_t i) {
+        for (const Document& document : search_server.FindTopDocuments(execution::seq, fuzzy_queries[i])) {
+            checksum += document.relevance;
+        }
+        }));
+    search_server.SetFuzzyMatching({});
+
+    //      30 -    
+    const int min_rating = 30;
+    results.push_back(Measure("FindTopDocuments/rating_predicate"s, queries.size(), 1, perf_counters, [&](size_t i) {
+        for (const Document& document : search_server.FindTopDocuments(queries[i],
+            [min_rating](int, DocumentStatus, int rating) { return rating >= min_rating; })) {
+            checksum += document.relevance;
+        }
+        }));
+    results.back().postings = queries_postings;
+
+    results.push_back(Measure("FindTopDocuments/min_rating"s, queries.size(), 1, perf_counters, [&](size_t i) {
+        for (const Document& document : search_server.FindTopDocumentsWithMinRating(queries[i], min_rating)) {
+            checksum += document.relevance;
+        }
+        }));
+    results.back().postings = queries_postings;
+
+    results.push_back(Measure("FindTopRatedDocuments"s, queries.size(), 1, perf_counters, [&](size_t i) {
+        for (const Document& document : search_server.FindTopRatedDocuments(queries[i])) {
+            checksum += document.rating;
+        }
+        }));
+
+    if (config.calibrate)
+    {
+        const ExecutionThresholds thresholds = CalibrateExecutionThresholds();
+        cerr << "Calibrated thresholds: parallel_min_work="s << thresholds.parallel_min_work
+            << ", partitioned_min_work="s << thresholds.partitioned_min_work << endl;
+        search_server.SetExecutionThresholds(thresholds);
+    }
+    results.push_back(Measure("FindTopDocuments/auto"s, queries.size(), 1, perf_counters, [&](size_t i) {
+        for (const Document& document : search_server.FindTopDocuments(auto_execution, queries[i])) {
+            checksum += document.relevance;
+        }
+        }));
+    results.back().postings = queries_postings;
+
+    //   ,       
+    {
+        ShardedSearchServer sharded_server(max(1u, thread::hardware_concurrency()));
+        sharded_server.SetPositionalIndex(config.positions);
+        for (size_t i = 0; i < documents.size(); ++i) {
+            sharded_server.AddDocument(static_cast<int>(i), documents[i], DocumentStatus::ACTUAL, { 1, 2, 3 });
+        }
+        results.push_back(Measure("FindTopDocuments/sharded"s, queries.size(), 1, perf_counters, [&](size_t i) {
+            for (const Document& document : sharded_server.FindTopDocuments(execution::par, queries[i])) {
+                checksum += document.relevance;
+            }
+            }));
+        results.back().postings = queries_postings;
+    }
+
+#ifdef __linux__
+    //    ;   ,  -  
+    if (!config.shard_worker.empty())
+    {
+        const size_t batch_size = 16;
+        vector<ShardProcess> shard_processes = StartLocalShards(max(1u, thread::hardware_concurrency()), "/tmp"s,
+            config.shard_worker, {}, config.positions);
+        try {
+            vector<string> socket_paths;
+            for (const ShardProcess& shard : shard_processes) {
+                socket_paths.push_back(shard.socket_path);
+            }
+            ShardCoordinator coordinator(socket_paths, 10s);
+            for (size_t i = 0; i < documents.size(); ++i) {
+                coordinator.AddDocument(static_cast<int>(i), documents[i], DocumentStatus::ACTUAL, { 1, 2, 3 });
+            }
+
+            const size_t batches_count = (queries.size() + batch_size - 1) / batch_size;
+            results.push_back(Measure("FindTopDocuments/shard_processes"s, batches_count, batch_size, perf_counters, [&](size_t i) {
+                const vector<string> batch(queries.begin() + i * batch_size, queries.begin() + min(queries.size(), (i + 1) * batch_size));
+                for (const ShardedSearchResult& result : coordinator.FindTopDocuments(batch)) {
+                    for (const Document& document : result.documents) {
+                        checksum += document.relevance;
+                    }
+                }
+                }));
+        }
+        catch (...) {
+            StopLocalShards(shard_processes);
+            throw;
+        }
+        StopLocalShards(shard_processes);
+    }
+
+    //     TCP  localhost;    ,   
+    {
+        const size_t batch_size = 16;
+        NetworkServer network_server(search_server);
+        network_server.Start();
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(network_server.GetPort());
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        const int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (connect(client_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0)
+        {
+            close(client_fd);
+            throw runtime_error("Cannot connect to the network server"s);
+        }
+
+        string requests;
+        string responses;
+        char buffer[64 * 1024];
+        const size_t batches_count = (queries.size() + batch_size - 1) / batch_size;
+        results.push_back(Measure("FindTopDocuments/tcp"s, batches_count, batch_size, perf_counters, [&](size_t i) {
+            const size_t batch_end = min(queries.size(), (i + 1) * batch_size);
+            requests.clear();
+            for (size_t query = i * batch_size; query < batch_end; ++query) {
+                requests += "FIND "s + queries[query] + "\n"s;
+            }
+            for (size_t sent = 0; sent < requests.size();) {
+                const ssize_t result = send(client_fd, requests.data() + sent, requests.size() - sent, MSG_NOSIGNAL);
+                if (result <= 0)
+                {
+                    throw runtime_error("Network server closed the connection"s);
+                }
+                sent += static_cast<size_t>(result);
+            }
+
+            //      
+            responses.clear();
+            size_t lines_count = 0;
+            while (lines_count < batch_end - i * batch_size) {
+                const ssize_t received = recv(client_fd, buffer, sizeof(buffer), 0);
+                if (received <= 0)
+                {
+                    throw runtime_error("Network server closed the connection"s);
+                }
+                lines_count += count(buffer, buffer + received, '\n');
+                responses.append(buffer, static_cast<size_t>(received));
+            }
+            checksum += static_cast<double>(responses.size());
+            }));
+        results.back().postings = queries_postings;
+
+        close(client_fd);
+        network_server.Stop();
+    }
+#endif
+
+    if (config.positions)
+    {
+        //       
+        vector<string> phrase_queries;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            const WordRange document_words = SplitIntoWords(documents[i * documents.size() / queries.size()]);
+            auto word = document_words.begin();
+            string phrase = "\""s + string(*word++);
+            if (word != document_words.end())
+            {
+                phrase += " "s + string(*word);
+            }
+            phrase_queries.push_back(phrase + "\""s);
+        }
+        results.push_back(Measure("FindTopDocuments/phrase"s, phrase_queries.size(), 1, perf_counters, [&](size_t i) {
+            for (const Document& document : search_server.FindTopDocuments(phrase_queries[i])) {
+                checksum += document.relevance;
+            }
+            }));
+    }
+
+    //       
+    const size_t match_count = max(queries.size(), min<size_t>(documents.size(), 10'000));
+    results.push_back(Measure("MatchDocument"s, match_count, 1, perf_counters, [&](size_t i) {
+        const auto [words, status] = search_server.MatchDocument(queries[i % queries.size()], static_cast<int>(i % documents.size()));
+        checksum += words.size();
+        }));
+
+    //       
+    const size_t match_many_count = min<size_t>(queries.size(), 10);
+    results.push_back(Measure("MatchDocuments/par"s, match_many_count, documents.size(), perf_counters, [&](size_t i) {
+        for (const auto& [words, status] : search_server.MatchDocuments(execution::par, queries[i], search_server)) {
+            checksum += words.size();
+        }
+        }));
+
+    const size_t batches_count = 5;
+    results.push_back(Measure("ProcessQueries"s, batches_count, queries.size(), perf_counters, [&](size_t) {
+        for (const auto& documents_found : ProcessQueries(search_server, queries)) {
+            checksum += documents_found.size();
+        }
+        }));
+    results.back().postings = queries_postings * batches_count;
+
+    //  :       
+    const size_t update_count = documents.size() / 10;
+    vector<string> edited_documents;
+    edited_documents.reserve(update_count);
+    for (size_t i = 0; i < update_count; ++i) {
+        const string& document = documents[i * 10 + 1];
+        const string_view replacement = *SplitIntoWords(documents[i * 10 + 2]).begin();
+        edited_documents.push_back(document.substr(0, document.rfind(' ') + 1) + string(replacement));
+    }
+    results.push_back(Measure("UpdateDocument"s, update_count, 1, perf_counters, [&](size_t i) {
+        search_server.UpdateDocument(static_cast<int>(i * 10 + 1), edited_documents[i], DocumentStatus::ACTUAL, { 1, 2, 3 });
+        }));
+    //       ,   
+    results.push_back(Measure("UpdateDocument/remove_add"s, update_count, 1, perf_counters, [&](size_t i) {
+        const int document_id = static_cast<int>(i * 10 + 1);
+        search_server.RemoveDocument(document_id);
+        search_server.AddDocument(document_id, documents[i * 10 + 1], DocumentStatus::ACTUAL, { 1, 2, 3 });
+        }));
+    results.push_back(Measure("UpdateDocument/metadata"s, update_count, 1, perf_counters, [&](size_t i) {
+        search_server.UpdateDocumentMetadata(static_cast<int>(i * 10 + 1), DocumentStatus::IRRELEVANT, { static_cast<int>(i % 97) });
+        }));
+
+    //    
+    const size_t remove_count = documents.size() / 10;
+    results.push_back(Measure("RemoveDocument"s, remove_count, 1, perf_counters, [&](size_t i) {
+        search_server.RemoveDocument(static_cast<int>(i * 10));
+        }));
+
+    //      :     
+    vector<int> batch_ids;
+    for (size_t i = 0; i < remove_count; ++i) {
+        batch_ids.push_back(static_cast<int>(i * 10 + 3));
+    }
+    results.push_back(Measure("RemoveDocuments/seq"s, 1, batch_ids.size(), perf_counters, [&](size_t) {
+        search_server.RemoveDocuments(execution::seq, batch_ids);
+        }));
+    for (int& document_id : batch_ids) {
+        document_id += 2;
+    }
+    results.push_back(Measure("RemoveDocuments/par"s, 1, batch_ids.size(), perf_counters, [&](size_t) {
+        search_server.RemoveDocuments(execution::par, batch_ids);
+        }));
+
+    //     ,      
+    {
+        SearchServer duplicates_server;
+        FillServer(duplicates_server, documents);
+        int next_id = static_cast<int>(documents.size());
+        for (size_t i = 0; i < documents.size(); i += 100) {
+            duplicates_server.AddDocument(next_id++, documents[i], DocumentStatus::ACTUAL, { 1 });
+        }
+
+        //        
+        ostringstream discarded;
+        auto* const cout_buffer = cout.rdbuf(discarded.rdbuf());
+        results.push_back(Measure("RemoveDuplicates"s, 1, duplicates_server.GetDocumentCount(), perf_counters, [&](size_t) {
+            RemoveDuplicates(duplicates_server);
+            }));
+        cout.rdbuf(cout_buffer);
+    }
+
+    //     :      
+    {
+        SearchServer texts_server;
+        DocumentStoreConfig document_store;
+        document_store.enabled = true;
+        texts_server.SetDocumentStore(document_store);
+        results.push_back(Measure("AddDocument/texts"s, documents.size(), 1, perf_counters, [&](size_t i) {
+            texts_server.AddDocument(static_cast<int>(i), documents[i], DocumentStatus::ACTUAL, { 1 });
+            }));
+
+        size_t texts_size = 0;
+        for (const string& document : documents) {
+            texts_size += document.size();
+        }
+        cerr << "document texts: "s << texts_size << " bytes, stored in "s
+            << texts_server.GetMemoryStats().document_texts << " bytes"s << endl;
+
+        results.push_back(Measure("GetDocumentTexts"s, queries.size(), 1, perf_counters, [&](size_t i) {
+            vector<int> documents_ids;
+            for (const Document& document : texts_server.FindTopDocuments(queries[i])) {
+                documents_ids.push_back(document.id);
+            }
+            for (const string& text : texts_server.GetDocumentTexts(documents_ids)) {
+                checksum += text.size();
+            }
+            }));
+    }
+
+    cerr << "checksum: "s << checksum << endl;
+    return results;
+}
+
+//  : ,       
+static void WriteCounters(ostream& output, const BenchmarkResult& result) {
+    if (result.postings > 0)
+    {
+        output << ", \"postings\": " << result.postings;
+    }
+
+    for (size_t i = 0; i < PERF_EVENTS_COUNT; ++i) {
+        const PerfEvent event = static_cast<PerfEvent>(i);
+        const auto& value = result.counters[event];
+        if (!value)
+        {
+            continue;
+        }
+        const string_view name = GetPerfEventName(event);
+        output << ", \"" << name << "\": " << *value
+            << ", \"" << name << "_per_item\": " << fixed << setprecision(2)
+            << static_cast<double>(*value) / max<uint64_t>(result.items, 1);
+        if (result.postings > 0)
+        {
+            output << ", \"" << name << "_per_posting\": "
+                << static_cast<double>(*value) / result.postings;
+        }
+        output << defaultfloat;
+    }
+
+    const auto& cycles = result.counters[PerfEvent::CYCLES];
+    const auto& instructions = result.counters[PerfEvent::INSTRUCTIONS];
+    if (cycles && instructions && *cycles > 0)
+    {
+        output << ", \"ipc\": " << fixed << setprecision(3)
+            << static_cast<double>(*instructions) / *cycles << defaultfloat;
+    }
+}
+
+static void WriteResults(ostream& output, const BenchmarkConfig& config, const vector<BenchmarkResult>& results) {
+    const bool has_counters = any_of(results.begin(), results.end(), [](const BenchmarkResult& result) {
+        return !result.counters.IsEmpty();
+        });
+
+    output << "{\n"
+        << "  \"config\": {\"docs\": " << config.documents_count
+        << ", \"doc_words\": " << config.document_words
+        << ", \"dictionary\": " << config.dictionary_size
+        << ", \"word_length\": " << config.max_word_length
+        << ", \"queries\": " << config.queries_count
+        << ", \"query_words\": " << config.query_words
+        << ", \"minus_prob\": " << config.minus_prob
+        << ", \"zipf\": " << config.zipf_exponent
+        << ", \"seed\": " << config.seed << "},\n"
+        << "  \"perf_counters\": " << (has_counters ? "true" : "false") << ",\n"
+        << "  \"peak_rss_kb\": " << GetPeakRssKb() << ",\n"
+        << "  \"benchmarks\": [";
+
+    bool is_first = true;
+    for (const BenchmarkResult& result : results) {
+        output << (is_first ? "\n" : ",\n")
+            << "    {\"name\": \"" << result.name << '"'
+            << ", \"operations\": " << result.operations
+            << ", \"items\": " << result.items
+            << ", \"seconds\": " << fixed << setprecision(6) << result.seconds
+            << ", \"items_per_second\": " << setprecision(1) << result.GetItemsPerSecond() << defaultfloat
+            << ", \"p50_ns\": " << result.latencies.GetPercentile(0.5).count()
+            << ", \"p99_ns\": " << result.latencies.GetPercentile(0.99).count()
+            << ", \"max_ns\": " << result.latencies.GetMax().count()
+            << ", \"allocations_per_op\": " << fixed << setprecision(1)
+            << static_cast<double>(result.allocations) / max<uint64_t>(result.operations, 1) << defaultfloat;
+        WriteCounters(output, result);
+        output << '}';
+        is_first = false;
+    }
+    output << "\n  ]\n}\n";
+}
+
+//         
+//  - ,   WriteResults:    
+static map<string, double> ReadBaseline(const string& file_name) {
+    ifstream input(file_name);
+    if (!input)
+    {
+        throw runtime_error("Cannot open baseline file "s + file_name);
+    }
+
+    const string name_key = "\"name\": \""s;
+    const string throughput_key = "\"items_per_second\": "s;
+
+    map<string, double> result;
+    string line;
+    while (getline(input, line)) {
+        const auto name_pos = line.find(name_key);
+        const auto throughput_pos = line.find(throughput_key);
+        if (name_pos == string::npos || throughput_pos == string::npos)
+        {
+            continue;
+        }
+        const auto name_begin = name_pos + name_key.size();
+        const string name = line.substr(name_begin, line.find('"', name_begin) - name_begin);
+        result[name] = stod(line.substr(throughput_pos + throughput_key.size()));
+    }
+    return result;
+}
+
+//    baseline;  false,    
+static bool CompareWithBaseline(const vector<BenchmarkResult>& results, const map<string, double>& baseline, double tolerance) {
+    bool passed = true;
+    cerr << "Comparison with baseline (items per second):"s << endl;
+    for (const BenchmarkResult& result : results) {
+        const auto it = baseline.find(result.name);
+        if (it == baseline.end() || it->second <= 0.)
+        {
+            cerr << "  "s << result.name << ": no baseline"s << endl;
+            continue;
+        }
+        const double ratio = result.GetItemsPerSecond() / it->second;
+        const bool regressed = ratio < 1. - tolerance;
+        passed = passed && !regressed;
+        cerr << "  "s << result.name << ": "s << fixed << setprecision(1) << it->second
+            << " -> "s << result.GetItemsPerSecond() << " ("s << setprecision(3) << ratio << "x)"s
+            << defaultfloat << (regressed ? " REGRESSION"s : ""s) << endl;
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        const BenchmarkConfig config = ParseArguments(argc, argv);
+        const Corpus corpus = GenerateCorpus(config);
+
+        //   ;   ,    
+        optional<PerfCounters> perf_counters;
+        if (config.perf_counters)
+        {
+            perf_counters.emplace();
+            if (!perf_counters->IsAvailable())
+            {
+                cerr << "Hardware performance counters are unavailable, continuing without them"s << endl;
+                perf_counters.reset();
+            }
+        }
+
+        const auto results = RunBenchmarks(config, corpus, perf_counters ? &*perf_counters : nullptr);
+
+        if (config.output_file.empty())
+        {
+            WriteResults(cout, config, results);
+        }
+        else
+        {
+            ofstream output(config.output_file);
+            WriteResults(output, config, results);
+        }
+
+        if (!config.baseline_file.empty()
+            && !CompareWithBaseline(results, ReadBaseline(config.baseline_file), config.tolerance))
+        {
+            return 1;
+        }
+    }
+    catch (const exception& e) {
+        cerr << "Benchmark failed: "s << e.what() << endl;
+        return 2;
+    }
+    return 0;
+}
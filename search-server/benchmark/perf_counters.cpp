@@ -0,0 +1,140 @@
+#include "perf_counters.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using namespace std;
+
+string_view GetPerfEventName(PerfEvent event) {
+    switch (event) {
+    case PerfEvent::CYCLES:
+        return "cycles"sv;
+    case PerfEvent::INSTRUCTIONS:
+        return "instructions"sv;
+    case PerfEvent::L1D_READ_MISSES:
+        return "l1d_read_misses"sv;
+    case PerfEvent::LLC_MISSES:
+        return "llc_misses"sv;
+    case PerfEvent::BRANCH_MISSES:
+        return "branch_misses"sv;
+    }
+    return "unknown"sv;
+}
+
+bool PerfCounterValues::IsEmpty() const {
+    return none_of(values.begin(), values.end(), [](const optional<uint64_t>& value) {
+        return value.has_value();
+        });
+}
+
+#ifdef __linux__
+
+//     perf   PerfEvent
+static pair<uint32_t, uint64_t> GetPerfEventConfig(PerfEvent event) {
+    switch (event) {
+    case PerfEvent::CYCLES:
+        return { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES };
+    case PerfEvent::INSTRUCTIONS:
+        return { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS };
+    case PerfEvent::L1D_READ_MISSES:
+        return { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) };
+    case PerfEvent::LLC_MISSES:
+        return { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES };
+    case PerfEvent::BRANCH_MISSES:
+        return { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES };
+    }
+    return { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES };
+}
+
+static int OpenPerfEvent(PerfEvent event) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    const auto [type, config] = GetPerfEventConfig(event);
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    //       ;    
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+PerfCounters::PerfCounters() {
+    for (size_t i = 0; i < PERF_EVENTS_COUNT; ++i) {
+        descriptors_[i] = OpenPerfEvent(static_cast<PerfEvent>(i));
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (const int descriptor : descriptors_) {
+        if (descriptor != -1)
+        {
+            close(descriptor);
+        }
+    }
+}
+
+void PerfCounters::Start() {
+    for (const int descriptor : descriptors_) {
+        if (descriptor != -1)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+PerfCounterValues PerfCounters::Stop() {
+    for (const int descriptor : descriptors_) {
+        if (descriptor != -1)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    PerfCounterValues result;
+    for (size_t i = 0; i < PERF_EVENTS_COUNT; ++i) {
+        // ,      
+        uint64_t data[3] = {};
+        if (descriptors_[i] == -1 || read(descriptors_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+        {
+            continue;
+        }
+        result.values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+    }
+    return result;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    descriptors_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::Start() {
+}
+
+PerfCounterValues PerfCounters::Stop() {
+    return {};
+}
+
+#endif
+
+bool PerfCounters::IsAvailable() const {
+    return any_of(descriptors_.begin(), descriptors_.end(), [](int descriptor) {
+        return descriptor != -1;
+        });
+}
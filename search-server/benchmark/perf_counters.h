@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/**
+ *    Linux (perf_event_open)   .
+ *
+ *    ,  .    
+ *     ( ,  ,  Linux),  
+ *  ,     .
+ *
+ *  PerfCounters counters;
+ *  counters.Start();
+ *  ...
+ *  const PerfCounterValues values = counters.Stop();
+ */
+
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_READ_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+};
+
+constexpr size_t PERF_EVENTS_COUNT = 5;
+
+//     
+std::string_view GetPerfEventName(PerfEvent event);
+
+struct PerfCounterValues {
+    std::array<std::optional<uint64_t>, PERF_EVENTS_COUNT> values;
+
+    const std::optional<uint64_t>& operator[](PerfEvent event) const {
+        return values[static_cast<size_t>(event)];
+    }
+
+    bool IsEmpty() const;
+};
+
+class PerfCounters {
+public:
+    PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters();
+
+    //       
+    bool IsAvailable() const;
+
+    void Start();
+
+    PerfCounterValues Stop();
+
+private:
+    //  ; -1 -  
+    std::array<int, PERF_EVENTS_COUNT> descriptors_;
+};
@@ -0,0 +1,295 @@
+#include "document_store.h"
+#include "lz_codec.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+//   ,    
+static const double MIN_LIVE_RATIO = 0.5;
+
+DocumentStore::DocumentStore(const allocator_type& alloc)
+    : locations_(alloc), blocks_(alloc), free_blocks_(alloc) {
+    blocks_.emplace_back();
+}
+
+void DocumentStore::SetConfig(const DocumentStoreConfig& config) {
+    block_size_ = max<size_t>(config.block_size, 1);
+    cache_blocks_ = config.cache_blocks;
+
+    lock_guard lock(cache_->mutex);
+    while (cache_->blocks.size() > cache_blocks_) {
+        cache_->positions.erase(cache_->blocks.back().first);
+        cache_->blocks.pop_back();
+    }
+}
+
+void DocumentStore::Add(int document_id, string_view text) {
+    locations_.emplace(document_id, AppendToOpenBlock(document_id, text));
+    texts_size_ += text.size();
+    if (blocks_[open_block_].data.size() >= block_size_)
+    {
+        CloseOpenBlock();
+    }
+}
+
+void DocumentStore::Remove(int document_id) {
+    const auto location_it = locations_.find(document_id);
+    if (location_it == locations_.end())
+    {
+        return;
+    }
+    const Location location = location_it->second;
+    locations_.erase(location_it);
+    texts_size_ -= location.size;
+
+    Block& block = blocks_[location.block];
+    block.live_size -= location.size;
+    if (--block.documents_count > 0)
+    {
+        if (location.block != open_block_ && block.live_size < block.raw_size * MIN_LIVE_RATIO)
+        {
+            CompactBlock(location.block);
+        }
+        return;
+    }
+    if (location.block == open_block_)
+    {
+        //        
+        block.data.clear();
+        block.entries.clear();
+    }
+    else
+    {
+        ReleaseBlock(location.block);
+    }
+}
+
+bool DocumentStore::Contains(int document_id) const {
+    return locations_.count(document_id) > 0;
+}
+
+string DocumentStore::GetText(int document_id) const {
+    const auto location_it = locations_.find(document_id);
+    if (location_it == locations_.end())
+    {
+        throw out_of_range("No stored text for given document id"s);
+    }
+    const Location& location = location_it->second;
+
+    if (location.block == open_block_)
+    {
+        return string(string_view(blocks_[open_block_].data).substr(location.offset, location.size));
+    }
+    return GetSealedBlock(location.block)->substr(location.offset, location.size);
+}
+
+vector<string> DocumentStore::GetTexts(const vector<int>& document_ids) const {
+    vector<const Location*> locations(document_ids.size());
+    for (size_t i = 0; i < document_ids.size(); ++i) {
+        const auto location_it = locations_.find(document_ids[i]);
+        if (location_it == locations_.end())
+        {
+            throw out_of_range("No stored text for given document id"s);
+        }
+        locations[i] = &location_it->second;
+    }
+
+    //    ,      
+    vector<size_t> order(document_ids.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return locations[lhs]->block < locations[rhs]->block;
+        });
+
+    vector<string> texts(document_ids.size());
+    shared_ptr<const string> block_data;
+    uint32_t current_block = open_block_;
+    for (const size_t i : order) {
+        const Location& location = *locations[i];
+        if (location.block == open_block_)
+        {
+            texts[i] = string(string_view(blocks_[open_block_].data).substr(location.offset, location.size));
+            continue;
+        }
+        if (location.block != current_block)
+        {
+            block_data = GetSealedBlock(location.block);
+            current_block = location.block;
+        }
+        texts[i] = block_data->substr(location.offset, location.size);
+    }
+    return texts;
+}
+
+size_t DocumentStore::GetTextsSize() const {
+    return texts_size_;
+}
+
+size_t DocumentStore::GetMemoryUsage() const {
+    return locations_.size() * GetMapNodeSize<int, Location>()
+        + blocks_.capacity() * sizeof(Block)
+        + free_blocks_.capacity() * sizeof(uint32_t)
+        + blocks_heap_size_;
+}
+
+shared_ptr<const string> DocumentStore::GetSealedBlock(uint32_t block) const {
+    BlockCache& cache = *cache_;
+    {
+        lock_guard lock(cache.mutex);
+        const auto position_it = cache.positions.find(block);
+        if (position_it != cache.positions.end())
+        {
+            cache.blocks.splice(cache.blocks.begin(), cache.blocks, position_it->second);
+            return position_it->second->second;
+        }
+    }
+
+    //    ,       
+    auto block_data = make_shared<const string>(DecompressLz(blocks_[block].data, blocks_[block].raw_size));
+
+    lock_guard lock(cache.mutex);
+    if (cache_blocks_ > 0 && cache.positions.count(block) == 0)
+    {
+        cache.blocks.emplace_front(block, block_data);
+        cache.positions[block] = cache.blocks.begin();
+        if (cache.blocks.size() > cache_blocks_)
+        {
+            cache.positions.erase(cache.blocks.back().first);
+            cache.blocks.pop_back();
+        }
+    }
+    return block_data;
+}
+
+DocumentStore::Location DocumentStore::AppendToOpenBlock(int document_id, string_view text) {
+    Block& block = blocks_[open_block_];
+    const Location location{ open_block_, block.data.size(), text.size() };
+
+    blocks_heap_size_ -= GetBlockHeapSize(block);
+    block.data.append(text);
+    block.entries.push_back({ document_id, location.offset });
+    blocks_heap_size_ += GetBlockHeapSize(block);
+    ++block.documents_count;
+    block.live_size += text.size();
+
+    return location;
+}
+
+void DocumentStore::CloseOpenBlock() {
+    const Block& block = blocks_[open_block_];
+    if (block.live_size < block.data.size() * MIN_LIVE_RATIO)
+    {
+        CompactOpenBlock();
+    }
+    else
+    {
+        SealOpenBlock();
+    }
+}
+
+void DocumentStore::SealOpenBlock() {
+    Block& block = blocks_[open_block_];
+    blocks_heap_size_ -= GetBlockHeapSize(block);
+    block.raw_size = block.data.size();
+    const string compressed = CompressLz(block.data);
+    block.data.assign(compressed);
+    block.data.shrink_to_fit();
+    block.entries.shrink_to_fit();
+    blocks_heap_size_ += GetBlockHeapSize(block);
+
+    open_block_ = AllocateBlock();
+}
+
+void DocumentStore::CompactOpenBlock() {
+    Block& block = blocks_[open_block_];
+    blocks_heap_size_ -= GetBlockHeapSize(block);
+
+    pmr::string data(block.data.get_allocator());
+    data.reserve(block.data.capacity());
+    size_t live_entries_count = 0;
+    for (const BlockEntry& entry : block.entries) {
+        const auto location_it = locations_.find(entry.document_id);
+        if (location_it == locations_.end() || location_it->second.block != open_block_
+            || location_it->second.offset != entry.offset)
+        {
+            continue;
+        }
+        Location& location = location_it->second;
+        const size_t offset = data.size();
+        data.append(block.data, location.offset, location.size);
+        location.offset = offset;
+        block.entries[live_entries_count++] = { entry.document_id, offset };
+    }
+    block.data.swap(data);
+    block.entries.resize(live_entries_count);
+
+    blocks_heap_size_ += GetBlockHeapSize(block);
+}
+
+void DocumentStore::CompactBlock(uint32_t block) {
+    const shared_ptr<const string> block_data = GetSealedBlock(block);
+    //  :       blocks_
+    const vector<BlockEntry> entries(blocks_[block].entries.begin(), blocks_[block].entries.end());
+
+    for (const BlockEntry& entry : entries) {
+        const auto location_it = locations_.find(entry.document_id);
+        if (location_it == locations_.end() || location_it->second.block != block
+            || location_it->second.offset != entry.offset)
+        {
+            continue;
+        }
+        const Location location = location_it->second;
+        location_it->second = AppendToOpenBlock(entry.document_id, string_view(*block_data).substr(location.offset, location.size));
+        if (blocks_[open_block_].data.size() >= block_size_)
+        {
+            CloseOpenBlock();
+        }
+    }
+
+    ReleaseBlock(block);
+}
+
+void DocumentStore::ReleaseBlock(uint32_t block) {
+    Block& released = blocks_[block];
+    blocks_heap_size_ -= GetBlockHeapSize(released);
+    released.data.clear();
+    released.data.shrink_to_fit();
+    released.entries.clear();
+    released.entries.shrink_to_fit();
+    blocks_heap_size_ += GetBlockHeapSize(released);
+    released.raw_size = 0;
+    released.documents_count = 0;
+    released.live_size = 0;
+    free_blocks_.push_back(block);
+
+    //     
+    DropCachedBlock(block);
+}
+
+size_t DocumentStore::GetBlockHeapSize(const Block& block) {
+    return GetStringHeapSize(block.data) + block.entries.capacity() * sizeof(BlockEntry);
+}
+
+void DocumentStore::DropCachedBlock(uint32_t block) {
+    lock_guard lock(cache_->mutex);
+    const auto position_it = cache_->positions.find(block);
+    if (position_it != cache_->positions.end())
+    {
+        cache_->blocks.erase(position_it->second);
+        cache_->positions.erase(position_it);
+    }
+}
+
+uint32_t DocumentStore::AllocateBlock() {
+    if (!free_blocks_.empty())
+    {
+        const uint32_t block = free_blocks_.back();
+        free_blocks_.pop_back();
+        return block;
+    }
+    blocks_.emplace_back();
+    return static_cast<uint32_t>(blocks_.size() - 1);
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "memory_stats.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct DocumentStoreConfig {
+    //   ,   
+    bool enabled = false;
+    //   :       ,    
+    //   
+    size_t block_size = 64u << 10;
+    //    
+    size_t cache_blocks = 16;
+};
+
+/**
+ *    .
+ *
+ *     ;    (lz_codec.h)  
+ *  .          
+ * ,        .
+ *        ,  
+ *    ,   ;     
+ *       .
+ *
+ *    ,    - .
+ */
+class DocumentStore {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    explicit DocumentStore(const allocator_type& alloc = {});
+
+    //     ;     cache_blocks
+    void SetConfig(const DocumentStoreConfig& config);
+
+    // document_id     
+    void Add(int document_id, std::string_view text);
+    void Remove(int document_id);
+    bool Contains(int document_id) const;
+
+    //  ; out_of_range,   
+    std::string GetText(int document_id) const;
+
+    //     document_ids;      
+    std::vector<std::string> GetTexts(const std::vector<int>& document_ids) const;
+
+    //    
+    size_t GetTextsSize() const;
+
+    //     ;      
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Location {
+        uint32_t block = 0;
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    // ,   ;        
+    struct BlockEntry {
+        int document_id = 0;
+        size_t offset = 0;
+    };
+
+    struct Block {
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        explicit Block(const allocator_type& alloc)
+            : data(alloc), entries(alloc) {
+        }
+
+        Block(const Block& other, const allocator_type& alloc)
+            : data(other.data, alloc), entries(other.entries, alloc), raw_size(other.raw_size)
+            , documents_count(other.documents_count), live_size(other.live_size) {
+        }
+
+        Block(Block&& other, const allocator_type& alloc)
+            : data(std::move(other.data), alloc), entries(std::move(other.entries), alloc), raw_size(other.raw_size)
+            , documents_count(other.documents_count), live_size(other.live_size) {
+        }
+
+        //  ;    - 
+        std::pmr::string data;
+        std::pmr::vector<BlockEntry> entries;
+        size_t raw_size = 0;
+        size_t documents_count = 0;
+        //    
+        size_t live_size = 0;
+    };
+
+    //     
+    struct BlockCache {
+        std::mutex mutex;
+        std::list<std::pair<uint32_t, std::shared_ptr<const std::string>>> blocks;
+        std::unordered_map<uint32_t, decltype(blocks)::iterator> positions;
+    };
+
+    std::pmr::map<int, Location> locations_;
+    std::pmr::vector<Block> blocks_;
+    //     
+    std::pmr::vector<uint32_t> free_blocks_;
+    uint32_t open_block_ = 0;
+
+    size_t block_size_ = DocumentStoreConfig().block_size;
+    size_t cache_blocks_ = DocumentStoreConfig().cache_blocks;
+    size_t texts_size_ = 0;
+    size_t blocks_heap_size_ = 0;
+
+    //    ,   ;  -   
+    std::unique_ptr<BlockCache> cache_ = std::make_unique<BlockCache>();
+
+private:
+    //       
+    std::shared_ptr<const std::string> GetSealedBlock(uint32_t block) const;
+
+    //         
+    Location AppendToOpenBlock(int document_id, std::string_view text);
+    //     ,      , 
+    void CloseOpenBlock();
+    void SealOpenBlock();
+    void CompactOpenBlock();
+    //          
+    void CompactBlock(uint32_t block);
+    void ReleaseBlock(uint32_t block);
+    static size_t GetBlockHeapSize(const Block& block);
+    void DropCachedBlock(uint32_t block);
+    uint32_t AllocateBlock();
+};
@@ -0,0 +1,163 @@
+#include "execution_planner.h"
+#include "search_server.h"
+#include "corpus_generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static atomic<size_t> active_queries_count{ 0 };
+
+ActiveQueryScope::ActiveQueryScope() {
+    active_queries_count.fetch_add(1, memory_order_relaxed);
+}
+
+ActiveQueryScope::~ActiveQueryScope() {
+    active_queries_count.fetch_sub(1, memory_order_relaxed);
+}
+
+size_t GetActiveQueriesCount() {
+    return active_queries_count.load(memory_order_relaxed);
+}
+
+ExecutionMode ChooseExecutionMode(const ExecutionCost& cost, const ExecutionThresholds& thresholds, size_t active_queries_count) {
+    const size_t threads_count = max(1u, thread::hardware_concurrency());
+
+    //      -       
+    const size_t other_queries_count = active_queries_count > 0 ? active_queries_count - 1 : 0;
+    if (other_queries_count > 0 && other_queries_count >= thresholds.max_load * threads_count)
+    {
+        return ExecutionMode::SEQUENTIAL;
+    }
+    //    :    ,      
+    if (threads_count < other_queries_count + 2)
+    {
+        return ExecutionMode::SEQUENTIAL;
+    }
+
+    if (cost.work < thresholds.parallel_min_work)
+    {
+        return ExecutionMode::SEQUENTIAL;
+    }
+    if (cost.work < thresholds.partitioned_min_work && cost.parallel_units >= thresholds.parallel_min_units)
+    {
+        return ExecutionMode::INTRA_QUERY_PARALLEL;
+    }
+    return ExecutionMode::PARTITIONED;
+}
+
+// seed  ;       
+static const unsigned CALIBRATION_SEED = 5489;
+
+//   :    , 
+static const size_t CALIBRATION_MIN_DOCUMENTS = 1000;
+static const size_t CALIBRATION_MAX_DOCUMENTS = 16000;
+
+//      
+static const int CALIBRATION_ROUNDS = 3;
+
+//  :         
+struct CalibrationPoint {
+    double work = 0.;
+    double sequential = 0.;
+    double intra_query = 0.;
+    double partitioned = 0.;
+    double parallel = 0.;
+};
+
+template <typename Policy>
+static double MeasureSearch(const SearchServer& search_server, const Policy& policy, const vector<string>& queries) {
+    using Clock = chrono::steady_clock;
+
+    double best_seconds = numeric_limits<double>::max();
+    for (int round = 0; round < CALIBRATION_ROUNDS; ++round) {
+        const auto start = Clock::now();
+        for (const string& query : queries) {
+            search_server.FindTopDocuments(policy, query);
+        }
+        best_seconds = min(best_seconds, chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best_seconds;
+}
+
+//  ,     faster   slower    
+static size_t FindCrossover(const vector<CalibrationPoint>& points,
+    double CalibrationPoint::* faster, double CalibrationPoint::* slower) {
+
+    size_t crossover = numeric_limits<size_t>::max();
+    for (auto point = points.rbegin(); point != points.rend() && (*point).*faster < (*point).*slower; ++point) {
+        crossover = static_cast<size_t>(point->work);
+    }
+    return crossover;
+}
+
+ExecutionThresholds CalibrateExecutionThresholds() {
+    mt19937 generator(CALIBRATION_SEED);
+    const auto dictionary = GenerateDictionary(generator, 2000, 10);
+    const ZipfDistribution distribution(dictionary.size(), 1.);
+    const auto queries = GenerateZipfQueries(generator, dictionary, distribution, 8, 8, 0.1);
+
+    // ,   auto_execution     
+    ExecutionThresholds partitioned_only;
+    partitioned_only.parallel_min_work = 0;
+    partitioned_only.partitioned_min_work = 0;
+    partitioned_only.max_load = numeric_limits<double>::max();
+
+    SearchServer search_server;
+    //      -     
+    map<string, size_t, less<>> documents_freqs;
+    vector<CalibrationPoint> points;
+
+    int document_id = 0;
+    for (size_t documents_count = CALIBRATION_MIN_DOCUMENTS; documents_count <= CALIBRATION_MAX_DOCUMENTS; documents_count *= 2) {
+        for (; static_cast<size_t>(document_id) < documents_count; ++document_id) {
+            const string document = GenerateZipfQuery(generator, dictionary, distribution, 30);
+            search_server.AddDocument(document_id, document, DocumentStatus::ACTUAL, { 1 });
+
+            const WordRange document_words = SplitIntoWords(document);
+            for (const string_view word : set<string_view>(document_words.begin(), document_words.end())) {
+                ++documents_freqs[string(word)];
+            }
+        }
+
+        CalibrationPoint point;
+        for (const string& query : queries) {
+            set<string_view> query_words;
+            for (string_view word : SplitIntoWords(query)) {
+                if (word[0] == '-')
+                {
+                    word.remove_prefix(1);
+                }
+                query_words.insert(word);
+            }
+            for (const string_view word : query_words) {
+                const auto freq = documents_freqs.find(word);
+                point.work += freq == documents_freqs.end() ? 0 : freq->second;
+            }
+        }
+        point.work /= queries.size();
+
+        search_server.SetExecutionThresholds(ExecutionThresholds());
+        point.sequential = MeasureSearch(search_server, execution::seq, queries);
+        point.intra_query = MeasureSearch(search_server, execution::par, queries);
+        search_server.SetExecutionThresholds(partitioned_only);
+        point.partitioned = MeasureSearch(search_server, auto_execution, queries);
+        point.parallel = min(point.intra_query, point.partitioned);
+
+        points.push_back(point);
+    }
+
+    ExecutionThresholds thresholds;
+    thresholds.parallel_min_work = FindCrossover(points, &CalibrationPoint::parallel, &CalibrationPoint::sequential);
+    thresholds.partitioned_min_work = FindCrossover(points, &CalibrationPoint::partitioned, &CalibrationPoint::intra_query);
+    return thresholds;
+}
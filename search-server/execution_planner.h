@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ *     .
+ *
+ *  SearchServer,   ,   auto_execution.
+ *     (     
+ *        ),   
+ *      ,   
+ *      id .
+ *
+ *  search_server.SetExecutionThresholds(CalibrateExecutionThresholds());
+ *  search_server.FindTopDocuments(auto_execution, query);
+ */
+
+struct AutoExecutionPolicy {
+};
+
+inline constexpr AutoExecutionPolicy auto_execution{};
+
+enum class ExecutionMode {
+    SEQUENTIAL,
+    //    
+    INTRA_QUERY_PARALLEL,
+    //    id 
+    PARTITIONED,
+};
+
+//   
+struct ExecutionCost {
+    //      
+    size_t work = 0;
+    //         
+    size_t parallel_units = 0;
+};
+
+//    
+struct ExecutionThresholds {
+    //     
+    size_t parallel_min_work = 50'000;
+    //        ,      
+    size_t partitioned_min_work = 1'000'000;
+    //        ,    
+    size_t parallel_min_units = 4;
+    //   ,   ,     
+    double max_load = 0.5;
+};
+
+ExecutionMode ChooseExecutionMode(const ExecutionCost& cost, const ExecutionThresholds& thresholds, size_t active_queries_count);
+
+//          
+class ActiveQueryScope {
+public:
+    ActiveQueryScope();
+
+    ActiveQueryScope(const ActiveQueryScope&) = delete;
+    ActiveQueryScope& operator=(const ActiveQueryScope&) = delete;
+
+    ~ActiveQueryScope();
+};
+
+//       
+size_t GetActiveQueriesCount();
+
+//          
+//  ;   
+ExecutionThresholds CalibrateExecutionThresholds();
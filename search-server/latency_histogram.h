@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ *      - 
+ * (  HDR Histogram):      SUB_BUCKETS_COUNT  ,
+ *       1 / SUB_BUCKETS_COUNT ( 3%).
+ *   2^MAX_EXPONENT  ( 69 )    .
+ *
+ *           :
+ *         ,  
+ *    .
+ */
+class LatencyHistogram {
+public:
+    using Duration = std::chrono::nanoseconds;
+
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKETS_COUNT = 1ull << SUB_BUCKET_BITS;
+    static constexpr int MAX_EXPONENT = 36;
+    static constexpr size_t BUCKETS_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS_COUNT;
+
+    void Record(Duration duration) {
+        const uint64_t value = ToValue(duration);
+        ++GetCount(BucketIndex(value));
+        ++total_count_;
+        max_value_ = std::max(max_value_, value);
+    }
+
+    // ,    :      
+    static size_t GetBucketIndex(Duration duration) {
+        return BucketIndex(ToValue(duration));
+    }
+
+    //  count   index; max -        
+    void AddBucketCount(size_t index, uint64_t count, Duration max) {
+        if (count == 0)
+        {
+            return;
+        }
+        GetCount(index) += static_cast<uint32_t>(count);
+        total_count_ += count;
+        max_value_ = std::max(max_value_, ToValue(max));
+    }
+
+    void Merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < other.counts_.size(); ++i) {
+            if (other.counts_[i] != 0)
+            {
+                GetCount(other.first_bucket_ + i) += other.counts_[i];
+            }
+        }
+        total_count_ += other.total_count_;
+        max_value_ = std::max(max_value_, other.max_value_);
+    }
+
+    //  ,     
+    void Clear() {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_count_ = 0;
+        max_value_ = 0;
+    }
+
+    uint64_t GetTotalCount() const {
+        return total_count_;
+    }
+
+    Duration GetMax() const {
+        return Duration(max_value_);
+    }
+
+    // ,    percentile ( 0  1)  
+    Duration GetPercentile(double percentile) const {
+        if (total_count_ == 0)
+        {
+            return Duration(0);
+        }
+
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile * total_count_ + 0.5));
+        uint64_t accumulated = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            accumulated += counts_[i];
+            if (accumulated >= rank)
+            {
+                return Duration(std::min(BucketUpperBound(first_bucket_ + i), max_value_));
+            }
+        }
+        return Duration(max_value_);
+    }
+
+    //    
+    size_t GetMemoryUsage() const {
+        return counts_.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    //   [first_bucket_, first_bucket_ + counts_.size())
+    std::vector<uint32_t> counts_;
+    size_t first_bucket_ = 0;
+    uint64_t total_count_ = 0;
+    uint64_t max_value_ = 0;
+
+    //  ;      
+    uint32_t& GetCount(size_t index) {
+        if (counts_.empty())
+        {
+            first_bucket_ = index;
+            counts_.push_back(0);
+        }
+        else if (index < first_bucket_)
+        {
+            counts_.insert(counts_.begin(), first_bucket_ - index, 0);
+            first_bucket_ = index;
+        }
+        else if (index >= first_bucket_ + counts_.size())
+        {
+            counts_.resize(index - first_bucket_ + 1, 0);
+        }
+        return counts_[index - first_bucket_];
+    }
+
+    static uint64_t ToValue(Duration duration) {
+        return static_cast<uint64_t>(std::max<Duration::rep>(duration.count(), 0));
+    }
+
+    static int HighestBit(uint64_t value) {
+        int bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+    }
+
+    static size_t BucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS_COUNT)
+        {
+            return static_cast<size_t>(value);
+        }
+        const int exponent = std::min(HighestBit(value), MAX_EXPONENT);
+        const uint64_t sub_bucket = value >= (2ull << MAX_EXPONENT)
+            ? SUB_BUCKETS_COUNT - 1
+            : (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS_COUNT - 1);
+        return static_cast<size_t>((exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS_COUNT + sub_bucket);
+    }
+
+    static uint64_t BucketUpperBound(size_t index) {
+        if (index < SUB_BUCKETS_COUNT)
+        {
+            return index;
+        }
+        const int exponent = static_cast<int>(index / SUB_BUCKETS_COUNT) + SUB_BUCKET_BITS - 1;
+        const uint64_t sub_bucket = index % SUB_BUCKETS_COUNT;
+        return ((SUB_BUCKETS_COUNT + sub_bucket + 1) << (exponent - SUB_BUCKET_BITS)) - 1;
+    }
+};
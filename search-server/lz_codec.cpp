@@ -0,0 +1,158 @@
+#include "lz_codec.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+static constexpr size_t MIN_MATCH_SIZE = 4;
+static constexpr size_t MAX_OFFSET = 0xFFFF;
+static constexpr int HASH_BITS = 14;
+static constexpr uint32_t NO_POSITION = UINT32_MAX;
+
+static uint32_t Load32(const char* data) {
+    uint32_t value = 0;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static uint32_t HashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// ,    4  :   255  
+static void PutLength(string& output, size_t length) {
+    while (length >= 255) {
+        output += static_cast<char>(255);
+        length -= 255;
+    }
+    output += static_cast<char>(length);
+}
+
+static void PutSequence(string& output, string_view literals, size_t offset, size_t match_size) {
+    const size_t match_code = match_size - MIN_MATCH_SIZE;
+    output += static_cast<char>((min<size_t>(literals.size(), 15) << 4) | min<size_t>(match_code, 15));
+    if (literals.size() >= 15)
+    {
+        PutLength(output, literals.size() - 15);
+    }
+    output += literals;
+    output += static_cast<char>(offset & 0xFF);
+    output += static_cast<char>(offset >> 8);
+    if (match_code >= 15)
+    {
+        PutLength(output, match_code - 15);
+    }
+}
+
+static void PutLastLiterals(string& output, string_view literals) {
+    output += static_cast<char>(min<size_t>(literals.size(), 15) << 4);
+    if (literals.size() >= 15)
+    {
+        PutLength(output, literals.size() - 15);
+    }
+    output += literals;
+}
+
+[[noreturn]] static void ThrowCorrupted() {
+    throw runtime_error("Corrupted compressed data"s);
+}
+
+static size_t GetLength(string_view compressed, size_t& pos, size_t length) {
+    if (length < 15)
+    {
+        return length;
+    }
+    while (true) {
+        if (pos >= compressed.size())
+        {
+            ThrowCorrupted();
+        }
+        const uint8_t byte = static_cast<uint8_t>(compressed[pos++]);
+        length += byte;
+        if (byte != 255)
+        {
+            return length;
+        }
+    }
+}
+
+string CompressLz(string_view data) {
+    string output;
+    output.reserve(data.size() / 2 + 16);
+
+    vector<uint32_t> positions(size_t(1) << HASH_BITS, NO_POSITION);
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + MIN_MATCH_SIZE <= data.size()) {
+        const uint32_t sequence = Load32(data.data() + pos);
+        uint32_t& candidate = positions[HashSequence(sequence)];
+        const uint32_t match_pos = candidate;
+        candidate = static_cast<uint32_t>(pos);
+
+        if (match_pos == NO_POSITION || pos - match_pos > MAX_OFFSET || Load32(data.data() + match_pos) != sequence)
+        {
+            ++pos;
+            continue;
+        }
+
+        size_t match_size = MIN_MATCH_SIZE;
+        while (pos + match_size < data.size() && data[match_pos + match_size] == data[pos + match_size]) {
+            ++match_size;
+        }
+        PutSequence(output, data.substr(anchor, pos - anchor), pos - match_pos, match_size);
+        pos += match_size;
+        anchor = pos;
+    }
+    PutLastLiterals(output, data.substr(anchor));
+
+    return output;
+}
+
+string DecompressLz(string_view compressed, size_t raw_size) {
+    string output;
+    output.reserve(raw_size);
+
+    size_t pos = 0;
+    while (pos < compressed.size()) {
+        const uint8_t token = static_cast<uint8_t>(compressed[pos++]);
+
+        const size_t literals_size = GetLength(compressed, pos, token >> 4);
+        if (literals_size > compressed.size() - pos || literals_size > raw_size - output.size())
+        {
+            ThrowCorrupted();
+        }
+        output.append(compressed.data() + pos, literals_size);
+        pos += literals_size;
+        if (pos == compressed.size())
+        {
+            break;
+        }
+
+        if (compressed.size() - pos < 2)
+        {
+            ThrowCorrupted();
+        }
+        const size_t offset = static_cast<uint8_t>(compressed[pos]) | (static_cast<size_t>(static_cast<uint8_t>(compressed[pos + 1])) << 8);
+        pos += 2;
+        const size_t match_size = GetLength(compressed, pos, token & 0x0F) + MIN_MATCH_SIZE;
+        if (offset == 0 || offset > output.size() || match_size > raw_size - output.size())
+        {
+            ThrowCorrupted();
+        }
+        //      ,    
+        const size_t match_pos = output.size() - offset;
+        for (size_t i = 0; i < match_size; ++i) {
+            output += output[match_pos + i];
+        }
+    }
+
+    if (output.size() != raw_size)
+    {
+        ThrowCorrupted();
+    }
+    return output;
+}
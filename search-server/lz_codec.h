@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ *   LZ77    (   LZ4).
+ *
+ *   -  : - ( 4  -  ,
+ *  -    4;  15    255), ,
+ *   (2 , little-endian)    . 
+ *     .   -  4    64 .
+ */
+
+//  data
+std::string CompressLz(std::string_view data);
+
+//  ,  CompressLz,    raw_size;
+//   - runtime_error
+std::string DecompressLz(std::string_view compressed, size_t raw_size);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+/**
+ *     .
+ *
+ *      :  std::map / std::set - 
+ *      -    , 
+ *  capacity() + 1 ,      .
+ *       .
+ */
+
+//    -    
+inline constexpr size_t TREE_NODE_OVERHEAD = sizeof(void*) * 4;
+
+template <typename Key, typename Value>
+constexpr size_t GetMapNodeSize() {
+    return TREE_NODE_OVERHEAD + sizeof(std::pair<const Key, Value>);
+}
+
+template <typename Key>
+constexpr size_t GetSetNodeSize() {
+    return TREE_NODE_OVERHEAD + sizeof(Key);
+}
+
+// ,  ;     
+template <typename Allocator>
+size_t GetStringHeapSize(const std::basic_string<char, std::char_traits<char>, Allocator>& str) {
+    const char* object = reinterpret_cast<const char*>(&str);
+    const bool is_inplace = std::greater_equal<const char*>()(str.data(), object)
+        && std::less<const char*>()(str.data(), object + sizeof(str));
+    return is_inplace ? 0 : str.capacity() + 1;
+}
+
+//   SearchServer  
+struct MemoryStats {
+    // id 
+    size_t documents_ids = 0;
+    //   (   )   word -> [ document_id, TF ]
+    size_t word_to_documents_freqs = 0;
+    // id -> [ word, TF ]
+    size_t document_to_words_freqs = 0;
+    //    ,     
+    size_t documents_data = 0;
+    size_t stop_words = 0;
+    //    
+    size_t document_texts = 0;
+
+    size_t GetTotal() const {
+        return documents_ids + word_to_documents_freqs + document_to_words_freqs + documents_data + stop_words
+            + document_texts;
+    }
+
+    MemoryStats& operator+=(const MemoryStats& other) {
+        documents_ids += other.documents_ids;
+        word_to_documents_freqs += other.word_to_documents_freqs;
+        document_to_words_freqs += other.document_to_words_freqs;
+        documents_data += other.documents_data;
+        stop_words += other.stop_words;
+        document_texts += other.document_texts;
+        return *this;
+    }
+
+    MemoryStats& operator-=(const MemoryStats& other) {
+        documents_ids -= other.documents_ids;
+        word_to_documents_freqs -= other.word_to_documents_freqs;
+        document_to_words_freqs -= other.document_to_words_freqs;
+        documents_data -= other.documents_data;
+        stop_words -= other.stop_words;
+        document_texts -= other.document_texts;
+        return *this;
+    }
+};
@@ -0,0 +1,234 @@
+#include "near_duplicates.h"
+
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+using namespace std;
+
+//  64-  ( splitmix64)
+static uint64_t MixHash(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+NearDuplicateDetector::NearDuplicateDetector(double similarity_threshold, size_t bands_count, size_t band_rows,
+    size_t max_bucket_size)
+    : similarity_threshold_(similarity_threshold)
+    , bands_count_(bands_count)
+    , band_rows_(band_rows)
+    , max_bucket_size_(max_bucket_size)
+    , bands_(bands_count) {
+
+    if (similarity_threshold < 0. || similarity_threshold > 1.)
+    {
+        throw invalid_argument("Similarity threshold must be in [0, 1]"s);
+    }
+
+    if (bands_count == 0 || band_rows == 0)
+    {
+        throw invalid_argument("Sketch must contain at least one band of one row"s);
+    }
+
+    if (max_bucket_size == 0)
+    {
+        throw invalid_argument("Max bucket size must be positive"s);
+    }
+}
+
+void NearDuplicateDetector::AddDocuments(const SearchServer& search_server) {
+    const vector<int> documents_id(search_server.begin(), search_server.end());
+
+    vector<Sketch> sketches(documents_id.size());
+    transform(execution::par, documents_id.begin(), documents_id.end(), sketches.begin(),
+        [&](int document_id) {
+            return ComputeSketch(search_server.GetWordFrequencies(document_id));
+        });
+
+    for (size_t i = 0; i < documents_id.size(); ++i) {
+        RemoveDocument(documents_id[i]);
+        InsertSketch(documents_id[i], move(sketches[i]));
+    }
+}
+
+void NearDuplicateDetector::AddDocument(const SearchServer& search_server, int document_id) {
+    RemoveDocument(document_id);
+    InsertSketch(document_id, ComputeSketch(search_server.GetWordFrequencies(document_id)));
+}
+
+void NearDuplicateDetector::RemoveDocument(int document_id) {
+    const auto sketch_it = sketches_.find(document_id);
+    if (sketch_it == sketches_.end())
+    {
+        return;
+    }
+
+    for (size_t band = 0; band < bands_count_; ++band) {
+        auto bucket_it = bands_[band].find(ComputeBandKey(sketch_it->second, band));
+        auto& bucket = bucket_it->second;
+        bucket.erase(find(bucket.begin(), bucket.end(), document_id));
+        if (bucket.empty())
+        {
+            bands_[band].erase(bucket_it);
+        }
+    }
+
+    sketches_.erase(sketch_it);
+}
+
+vector<pair<int, int>> NearDuplicateDetector::FindNearDuplicates(const SearchServer& search_server) const {
+    // ,      ;      
+    vector<pair<int, int>> candidates;
+    vector<int> sorted_bucket;
+    for (const auto& band : bands_) {
+        for (const auto& [key, bucket] : band) {
+            if (bucket.size() <= max_bucket_size_)
+            {
+                for (size_t i = 0; i < bucket.size(); ++i) {
+                    for (size_t j = i + 1; j < bucket.size(); ++j) {
+                        candidates.push_back(minmax(bucket[i], bucket[j]));
+                    }
+                }
+                continue;
+            }
+
+            //        max_bucket_size    id:
+            // O(  * max_bucket_size)    
+            sorted_bucket.assign(bucket.begin(), bucket.end());
+            partial_sort(sorted_bucket.begin(), sorted_bucket.begin() + max_bucket_size_, sorted_bucket.end());
+            for (size_t i = 0; i < max_bucket_size_; ++i) {
+                for (size_t j = i + 1; j < sorted_bucket.size(); ++j) {
+                    candidates.emplace_back(sorted_bucket[i], sorted_bucket[j]);
+                }
+            }
+        }
+    }
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+    vector<char> confirmed(candidates.size());
+    transform(execution::par, candidates.begin(), candidates.end(), confirmed.begin(),
+        [&](const pair<int, int>& candidate) {
+            return IsNearDuplicate(search_server, candidate.first, candidate.second);
+        });
+
+    vector<pair<int, int>> result;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (confirmed[i])
+        {
+            result.push_back(candidates[i]);
+        }
+    }
+    return result;
+}
+
+vector<int> NearDuplicateDetector::FindNearDuplicates(const SearchServer& search_server, int document_id) const {
+    const auto sketch_it = sketches_.find(document_id);
+    if (sketch_it == sketches_.end())
+    {
+        return {};
+    }
+
+    set<int> candidates;
+    for (size_t band = 0; band < bands_count_; ++band) {
+        const auto& bucket = bands_[band].at(ComputeBandKey(sketch_it->second, band));
+        candidates.insert(bucket.begin(), bucket.end());
+    }
+    candidates.erase(document_id);
+
+    vector<int> result;
+    for (const int candidate_id : candidates) {
+        if (IsNearDuplicate(search_server, document_id, candidate_id))
+        {
+            result.push_back(candidate_id);
+        }
+    }
+    return result;
+}
+
+// i-   -  i- -   
+NearDuplicateDetector::Sketch NearDuplicateDetector::ComputeSketch(const WordFrequencies& words_freqs) const {
+    const hash<string_view> hasher;
+    Sketch sketch(bands_count_ * band_rows_, numeric_limits<uint64_t>::max());
+
+    for (const auto& [word, freq] : words_freqs) {
+        const uint64_t word_hash = hasher(word);
+        for (size_t i = 0; i < sketch.size(); ++i) {
+            sketch[i] = min(sketch[i], MixHash(word_hash + (i + 1) * 0x9e3779b97f4a7c15ull));
+        }
+    }
+
+    return sketch;
+}
+
+uint64_t NearDuplicateDetector::ComputeBandKey(const Sketch& sketch, size_t band) const {
+    uint64_t key = band;
+    for (size_t row = band * band_rows_; row < (band + 1) * band_rows_; ++row) {
+        key = MixHash(key ^ sketch[row]);
+    }
+    return key;
+}
+
+void NearDuplicateDetector::InsertSketch(int document_id, Sketch sketch) {
+    for (size_t band = 0; band < bands_count_; ++band) {
+        bands_[band][ComputeBandKey(sketch, band)].push_back(document_id);
+    }
+    sketches_.emplace(document_id, move(sketch));
+}
+
+bool NearDuplicateDetector::IsNearDuplicate(const SearchServer& search_server, int lhs_id, int rhs_id) const {
+    return ComputeJaccardSimilarity(search_server.GetWordFrequencies(lhs_id), search_server.GetWordFrequencies(rhs_id))
+        >= similarity_threshold_;
+}
+
+double ComputeJaccardSimilarity(const WordFrequencies& lhs, const WordFrequencies& rhs) {
+    if (lhs.empty() && rhs.empty())
+    {
+        return 1.;
+    }
+
+    //     ,    
+    size_t intersection_size = 0;
+    auto lhs_it = lhs.begin();
+    auto rhs_it = rhs.begin();
+    while (lhs_it != lhs.end() && rhs_it != rhs.end())
+    {
+        if (lhs_it->first < rhs_it->first)
+        {
+            ++lhs_it;
+        }
+        else if (rhs_it->first < lhs_it->first)
+        {
+            ++rhs_it;
+        }
+        else
+        {
+            ++intersection_size;
+            ++lhs_it;
+            ++rhs_it;
+        }
+    }
+
+    return static_cast<double>(intersection_size) / (lhs.size() + rhs.size() - intersection_size);
+}
+
+void RemoveNearDuplicates(SearchServer& search_server, double similarity_threshold) {
+    NearDuplicateDetector detector(similarity_threshold);
+    detector.AddDocuments(search_server);
+
+    //     id,     - 
+    set<int> removed_documents_id;
+    for (const auto& [kept_id, duplicate_id] : detector.FindNearDuplicates(search_server)) {
+        if (!removed_documents_id.count(kept_id) && removed_documents_id.insert(duplicate_id).second)
+        {
+            cout << "Found near-duplicate document id "s << duplicate_id << " of "s << kept_id << endl;
+        }
+    }
+
+    search_server.RemoveDocuments(execution::par, vector<int>(removed_documents_id.begin(), removed_documents_id.end()));
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "search_server.h"
+
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ *  -: ,     
+ *    .
+ *
+ *     MinHash-  bands_count * band_rows .
+ *      band_rows ; ,   
+ *   ,       .
+ *      max_bucket_size  (  ),  
+ *     max_bucket_size    id,    .
+ *
+ *     :
+ *
+ *  NearDuplicateDetector detector(0.8);
+ *  detector.AddDocuments(search_server);
+ *  ...
+ *  search_server.AddDocument(id, text, status, ratings);
+ *  detector.AddDocument(search_server, id);
+ *  ...
+ *  detector.RemoveDocument(id);
+ *  search_server.RemoveDocument(id);
+ */
+class NearDuplicateDetector {
+public:
+    explicit NearDuplicateDetector(double similarity_threshold, size_t bands_count = 20, size_t band_rows = 5,
+        size_t max_bucket_size = 100);
+
+    //      ()
+    void AddDocuments(const SearchServer& search_server);
+
+    //   ,    
+    void AddDocument(const SearchServer& search_server, int document_id);
+
+    void RemoveDocument(int document_id);
+
+    //  {  id,  id } -,   
+    std::vector<std::pair<int, int>> FindNearDuplicates(const SearchServer& search_server) const;
+
+    // -     id
+    std::vector<int> FindNearDuplicates(const SearchServer& search_server, int document_id) const;
+
+private:
+    using Sketch = std::vector<uint64_t>;
+
+    double similarity_threshold_;
+    size_t bands_count_;
+    size_t band_rows_;
+    size_t max_bucket_size_;
+
+    // id -> 
+    std::map<int, Sketch> sketches_;
+
+    //   :   -> id 
+    std::vector<std::unordered_map<uint64_t, std::vector<int>>> bands_;
+
+private:
+    Sketch ComputeSketch(const WordFrequencies& words_freqs) const;
+
+    uint64_t ComputeBandKey(const Sketch& sketch, size_t band) const;
+
+    void InsertSketch(int document_id, Sketch sketch);
+
+    bool IsNearDuplicate(const SearchServer& search_server, int lhs_id, int rhs_id) const;
+};
+
+//      
+double ComputeJaccardSimilarity(const WordFrequencies& lhs, const WordFrequencies& rhs);
+
+//  -;        id
+void RemoveNearDuplicates(SearchServer& search_server, double similarity_threshold);
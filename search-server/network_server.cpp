@@ -0,0 +1,668 @@
+#include "network_server.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <execution>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+//    ;    
+static string_view PopWord(string_view& text) {
+    const size_t begin = text.find_first_not_of(' ');
+    if (begin == string_view::npos)
+    {
+        text = {};
+        return {};
+    }
+    text.remove_prefix(begin);
+    const size_t end = min(text.find(' '), text.size());
+    const string_view word = text.substr(0, end);
+    text.remove_prefix(end);
+    return word;
+}
+
+//    :    ,   -  
+static string_view PopTail(string_view& text) {
+    if (!text.empty() && text.front() == ' ')
+    {
+        text.remove_prefix(1);
+    }
+    const string_view tail = text;
+    text = {};
+    return tail;
+}
+
+static int ParseInt(string_view word) {
+    int value = 0;
+    const auto [end, error] = from_chars(word.data(), word.data() + word.size(), value);
+    if (word.empty() || error != errc() || end != word.data() + word.size())
+    {
+        throw invalid_argument("Invalid number: "s + string(word));
+    }
+    return value;
+}
+
+static DocumentStatus ParseStatus(string_view word) {
+    if (word == "ACTUAL"sv)
+    {
+        return DocumentStatus::ACTUAL;
+    }
+    if (word == "IRRELEVANT"sv)
+    {
+        return DocumentStatus::IRRELEVANT;
+    }
+    if (word == "BANNED"sv)
+    {
+        return DocumentStatus::BANNED;
+    }
+    if (word == "REMOVED"sv)
+    {
+        return DocumentStatus::REMOVED;
+    }
+    throw invalid_argument("Invalid document status: "s + string(word));
+}
+
+static string_view GetStatusName(DocumentStatus status) {
+    switch (status) {
+    case DocumentStatus::ACTUAL:
+        return "ACTUAL"sv;
+    case DocumentStatus::IRRELEVANT:
+        return "IRRELEVANT"sv;
+    case DocumentStatus::BANNED:
+        return "BANNED"sv;
+    case DocumentStatus::REMOVED:
+        return "REMOVED"sv;
+    }
+    return "UNKNOWN"sv;
+}
+
+// ADD, UPDATE  REMOVE  ,     
+static bool IsWriteRequest(string_view request) {
+    const string_view command = PopWord(request);
+    return command == "ADD"sv || command == "UPDATE"sv || command == "REMOVE"sv;
+}
+
+static void AppendNumber(string& output, double value) {
+    char buffer[32];
+    const auto result = to_chars(begin(buffer), end(buffer), value);
+    output.append(buffer, result.ptr);
+}
+
+static void AppendNumber(string& output, int value) {
+    char buffer[16];
+    const auto result = to_chars(begin(buffer), end(buffer), value);
+    output.append(buffer, result.ptr);
+}
+
+static int OpenListenSocket(const string& address, uint16_t port) {
+
+    sockaddr_in socket_address = {};
+    socket_address.sin_family = AF_INET;
+    socket_address.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &socket_address.sin_addr) != 1)
+    {
+        throw invalid_argument("Invalid listen address: "s + address);
+    }
+
+    const int listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0)
+    {
+        throw system_error(errno, generic_category(), "socket"s);
+    }
+
+    const int enabled = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEPORT, &enabled, sizeof(enabled));
+    if (bind(listen_fd, reinterpret_cast<const sockaddr*>(&socket_address), sizeof(socket_address)) < 0
+        || listen(listen_fd, SOMAXCONN) < 0)
+    {
+        const int error = errno;
+        close(listen_fd);
+        throw system_error(error, generic_category(), "Cannot listen on "s + address + ":"s + to_string(port));
+    }
+
+    return listen_fd;
+}
+
+class NetworkServer::EventLoop {
+public:
+    EventLoop(NetworkServer& server, int listen_fd)
+        : server_(server), listen_fd_(listen_fd) {
+
+        //      :   
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd_ < 0 || wake_fd_ < 0)
+        {
+            const int error = errno;
+            listen_fd_ = -1;
+            CloseAll();
+            throw system_error(error, generic_category(), "epoll"s);
+        }
+        try {
+            Watch(listen_fd_, EPOLLIN, EPOLL_CTL_ADD);
+            Watch(wake_fd_, EPOLLIN, EPOLL_CTL_ADD);
+        }
+        catch (...) {
+            listen_fd_ = -1;
+            CloseAll();
+            throw;
+        }
+    }
+
+    ~EventLoop() {
+        CloseAll();
+    }
+
+    void Run() {
+        vector<epoll_event> events(256);
+        while (!stopped_) {
+            //    ,     
+            const int count = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), pending_.empty() ? -1 : 0);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+
+            for (int i = 0; i < count; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == wake_fd_)
+                {
+                    uint64_t value = 0;
+                    [[maybe_unused]] const ssize_t result = read(wake_fd_, &value, sizeof(value));
+                    continue;
+                }
+                if (fd == listen_fd_)
+                {
+                    Accept();
+                    continue;
+                }
+
+                const auto connection_it = connections_.find(fd);
+                if (connection_it == connections_.end())
+                {
+                    continue;
+                }
+                Connection& connection = connection_it->second;
+                if (events[i].events & EPOLLERR)
+                {
+                    Close(connection);
+                    continue;
+                }
+                if (events[i].events & EPOLLOUT)
+                {
+                    Flush(connection);
+                    if (connections_.count(fd) == 0)
+                    {
+                        continue;
+                    }
+                }
+                if (events[i].events & (EPOLLIN | EPOLLHUP))
+                {
+                    Read(connection);
+                }
+            }
+
+            ProcessRequests();
+        }
+    }
+
+    //    Run  Stop
+    void Reset() {
+        stopped_ = false;
+    }
+
+    // Run    
+    void Stop() {
+        stopped_ = true;
+        const uint64_t value = 1;
+        [[maybe_unused]] const ssize_t result = write(wake_fd_, &value, sizeof(value));
+    }
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string input;
+        //    input
+        size_t input_offset = 0;
+        std::string output;
+        // ,      epoll
+        uint32_t events = 0;
+        //     
+        bool input_closed = false;
+        //    pending_
+        bool pending = false;
+    };
+
+    NetworkServer& server_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic_bool stopped_ = false;
+
+    std::unordered_map<int, Connection> connections_;
+    // ,       
+    std::vector<int> pending_;
+
+    //     
+    std::vector<std::string_view> requests_;
+    std::vector<std::string> responses_;
+    std::vector<std::pair<int, size_t>> requests_counts_;
+
+private:
+    void Watch(int fd, uint32_t events, int operation) {
+        epoll_event event = {};
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, operation, fd, &event) < 0)
+        {
+            throw system_error(errno, generic_category(), "epoll_ctl"s);
+        }
+    }
+
+    void Accept() {
+        while (true) {
+            const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+            {
+                // EAGAIN -  ;      
+                if (errno == EINTR || errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                return;
+            }
+
+            //   ,    
+            const int enabled = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+
+            Connection& connection = connections_[fd];
+            connection.fd = fd;
+            connection.events = EPOLLIN;
+            Watch(fd, connection.events, EPOLL_CTL_ADD);
+        }
+    }
+
+    void Read(Connection& connection) {
+        char buffer[64 * 1024];
+        const ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0)
+        {
+            connection.input.append(buffer, static_cast<size_t>(received));
+        }
+        else if (received == 0)
+        {
+            connection.input_closed = true;
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            Close(connection);
+            return;
+        }
+        MarkPending(connection);
+    }
+
+    void Flush(Connection& connection) {
+        size_t sent_size = 0;
+        while (sent_size < connection.output.size()) {
+            const ssize_t sent = send(connection.fd, connection.output.data() + sent_size, connection.output.size() - sent_size, MSG_NOSIGNAL);
+            if (sent > 0)
+            {
+                sent_size += static_cast<size_t>(sent);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                break;
+            }
+            Close(connection);
+            return;
+        }
+        connection.output.erase(0, sent_size);
+        //      
+        MarkPending(connection);
+    }
+
+    void MarkPending(Connection& connection) {
+        if (!connection.pending)
+        {
+            connection.pending = true;
+            pending_.push_back(connection.fd);
+        }
+    }
+
+    //   max_pipeline_size     pending_     
+    void ProcessRequests() {
+        const NetworkServerConfig& config = server_.config_;
+
+        requests_.clear();
+        requests_counts_.clear();
+        for (const int fd : pending_) {
+            const auto connection_it = connections_.find(fd);
+            //    ,    -   
+            if (connection_it == connections_.end() || !connection_it->second.pending)
+            {
+                continue;
+            }
+            Connection& connection = connection_it->second;
+            connection.pending = false;
+
+            size_t requests_count = 0;
+            while (requests_count < config.max_pipeline_size && connection.output.size() < config.max_output_size) {
+                const size_t line_end = connection.input.find('\n', connection.input_offset);
+                if (line_end == string::npos)
+                {
+                    break;
+                }
+                string_view request(connection.input.data() + connection.input_offset, line_end - connection.input_offset);
+                if (!request.empty() && request.back() == '\r')
+                {
+                    request.remove_suffix(1);
+                }
+                requests_.push_back(request);
+                connection.input_offset = line_end + 1;
+                ++requests_count;
+            }
+            requests_counts_.push_back({ fd, requests_count });
+        }
+
+        server_.HandleRequests(requests_, responses_);
+
+        vector<int> pending;
+        size_t response_index = 0;
+        for (const auto& [fd, requests_count] : requests_counts_) {
+            Connection& connection = connections_.at(fd);
+            for (size_t i = 0; i < requests_count; ++i) {
+                connection.output += responses_[response_index++];
+            }
+
+            //    input,      
+            connection.input.erase(0, connection.input_offset);
+            connection.input_offset = 0;
+            Flush(connection);
+            if (connections_.count(fd) == 0)
+            {
+                continue;
+            }
+
+            const bool has_request = connection.input.find('\n') != string::npos;
+            if (!has_request && connection.input.size() >= config.max_line_size)
+            {
+                Close(connection);
+                continue;
+            }
+            if (!has_request && connection.input_closed && connection.output.empty())
+            {
+                Close(connection);
+                continue;
+            }
+            connection.pending = has_request && connection.output.size() < config.max_output_size;
+            if (connection.pending)
+            {
+                pending.push_back(fd);
+            }
+            UpdateEvents(connection);
+        }
+        pending_ = move(pending);
+    }
+
+    //  ,          
+    void UpdateEvents(Connection& connection) {
+        const NetworkServerConfig& config = server_.config_;
+        uint32_t events = 0;
+        if (!connection.input_closed && connection.output.size() < config.max_output_size
+            && connection.input.size() < config.max_line_size)
+        {
+            events |= EPOLLIN;
+        }
+        if (!connection.output.empty())
+        {
+            events |= EPOLLOUT;
+        }
+        if (events != connection.events)
+        {
+            connection.events = events;
+            Watch(connection.fd, events, EPOLL_CTL_MOD);
+        }
+    }
+
+    void Close(Connection& connection) {
+        close(connection.fd);
+        connections_.erase(connection.fd);
+    }
+
+    void CloseAll() {
+        for (auto& [fd, connection] : connections_) {
+            close(fd);
+        }
+        connections_.clear();
+        for (const int fd : { listen_fd_, epoll_fd_, wake_fd_ }) {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+        listen_fd_ = epoll_fd_ = wake_fd_ = -1;
+    }
+};
+
+NetworkServer::NetworkServer(SearchServer& search_server, const NetworkServerConfig& config)
+    : search_server_(search_server), config_(config) {
+
+    const size_t threads_count = config_.threads > 0 ? config_.threads : max(1u, thread::hardware_concurrency());
+    port_ = config_.port;
+    for (size_t i = 0; i < threads_count; ++i) {
+        //   0     ,   
+        const int listen_fd = OpenListenSocket(config_.address, port_);
+        if (i == 0)
+        {
+            sockaddr_in socket_address = {};
+            socklen_t address_size = sizeof(socket_address);
+            getsockname(listen_fd, reinterpret_cast<sockaddr*>(&socket_address), &address_size);
+            port_ = ntohs(socket_address.sin_port);
+        }
+        unique_ptr<EventLoop> loop;
+        try {
+            loop = make_unique<EventLoop>(*this, listen_fd);
+        }
+        catch (...) {
+            close(listen_fd);
+            throw;
+        }
+        //     
+        loops_.push_back(move(loop));
+    }
+}
+
+NetworkServer::~NetworkServer() {
+    Stop();
+}
+
+uint16_t NetworkServer::GetPort() const {
+    return port_;
+}
+
+void NetworkServer::Start() {
+    if (!threads_.empty())
+    {
+        return;
+    }
+    for (const auto& loop : loops_) {
+        loop->Reset();
+    }
+    for (const auto& loop : loops_) {
+        threads_.emplace_back([&loop] {
+            loop->Run();
+            });
+    }
+}
+
+void NetworkServer::Stop() {
+    for (const auto& loop : loops_) {
+        loop->Stop();
+    }
+    for (thread& loop_thread : threads_) {
+        loop_thread.join();
+    }
+    threads_.clear();
+}
+
+string NetworkServer::HandleRequest(string_view request) {
+    vector<string> responses;
+    HandleRequests({ request }, responses);
+    return move(responses.front());
+}
+
+void NetworkServer::HandleRequests(const vector<string_view>& requests, vector<string>& responses) {
+
+    TRACE_SPAN("NetworkHandleRequests");
+
+    responses.resize(requests.size());
+
+    size_t begin = 0;
+    while (begin < requests.size()) {
+        if (IsWriteRequest(requests[begin]))
+        {
+            const unique_lock lock(search_server_mutex_);
+            responses[begin] = HandleWriteRequest(requests[begin]);
+            ++begin;
+            continue;
+        }
+
+        //       
+        size_t end = begin + 1;
+        while (end < requests.size() && !IsWriteRequest(requests[end])) {
+            ++end;
+        }
+
+        const shared_lock lock(search_server_mutex_);
+        if (end - begin == 1)
+        {
+            responses[begin] = HandleReadRequest(requests[begin]);
+        }
+        else
+        {
+            vector<size_t> indexes(end - begin);
+            iota(indexes.begin(), indexes.end(), begin);
+            for_each(execution::par, indexes.begin(), indexes.end(), [&](size_t i) {
+                responses[i] = HandleReadRequest(requests[i]);
+                });
+        }
+        begin = end;
+    }
+}
+
+string NetworkServer::HandleReadRequest(string_view request) const {
+    string response;
+    try {
+        const string_view command = PopWord(request);
+        if (command == "FIND"sv)
+        {
+            const vector<Document> documents = search_server_.FindTopDocuments(request);
+            response = "DOCUMENTS "s;
+            AppendNumber(response, static_cast<int>(documents.size()));
+            for (const Document& document : documents) {
+                response += ' ';
+                AppendNumber(response, document.id);
+                response += ' ';
+                AppendNumber(response, document.relevance);
+                response += ' ';
+                AppendNumber(response, document.rating);
+            }
+        }
+        else if (command == "MATCH"sv)
+        {
+            const int document_id = ParseInt(PopWord(request));
+            const auto [words, status] = search_server_.MatchDocument(request, document_id);
+            response = "MATCHED "s;
+            response += GetStatusName(status);
+            for (const string_view word : words) {
+                response += ' ';
+                response += word;
+            }
+        }
+        else if (command == "TEXT"sv)
+        {
+            response = "TEXT "s + search_server_.GetDocumentText(ParseInt(PopWord(request)));
+        }
+        else
+        {
+            throw invalid_argument("Unknown command: "s + string(command));
+        }
+    }
+    catch (const exception& e) {
+        response = "ERROR "s + e.what();
+    }
+    response += '\n';
+    return response;
+}
+
+string NetworkServer::HandleWriteRequest(string_view request) {
+    try {
+        const string_view command = PopWord(request);
+        if (command == "ADD"sv || command == "UPDATE"sv)
+        {
+            const int document_id = ParseInt(PopWord(request));
+            const DocumentStatus status = ParseStatus(PopWord(request));
+            const int ratings_count = ParseInt(PopWord(request));
+            if (ratings_count < 0)
+            {
+                throw invalid_argument("Ratings count is negative"s);
+            }
+            //      :       
+            vector<int> ratings;
+            for (int i = 0; i < ratings_count; ++i) {
+                const string_view rating = PopWord(request);
+                if (rating.empty())
+                {
+                    throw invalid_argument("Fewer ratings than declared"s);
+                }
+                ratings.push_back(ParseInt(rating));
+            }
+            const string_view text = PopTail(request);
+            if (command == "ADD"sv)
+            {
+                search_server_.AddDocument(document_id, text, status, ratings);
+            }
+            else
+            {
+                search_server_.UpdateDocument(document_id, text, status, ratings);
+            }
+        }
+        else
+        {
+            search_server_.RemoveDocument(ParseInt(PopWord(request)));
+        }
+        return "OK\n"s;
+    }
+    catch (const exception& e) {
+        return "ERROR "s + e.what() + "\n"s;
+    }
+}
+
+#endif
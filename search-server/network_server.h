@@ -0,0 +1,98 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "search_server.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct NetworkServerConfig {
+    // 0 -    (. GetPort)
+    uint16_t port = 0;
+    // ,    
+    std::string address = "127.0.0.1";
+    //  ,    ; 0 -    
+    size_t threads = 0;
+    //   ,    
+    size_t max_pipeline_size = 64;
+    //   ,      
+    size_t max_output_size = 1u << 20;
+    //     
+    size_t max_line_size = 1u << 20;
+};
+
+/**
+ * TCP-,  SearchServer  .
+ *
+ *  :    -   ,  '\n'.
+ *  ADD <id> <status> < > <...> <>  -> OK
+ *  UPDATE <id> <status> < > <...> <> -> OK
+ *  REMOVE <id>                                            -> OK
+ *  FIND <>                                          -> DOCUMENTS <> [<id> <relevance> <rating>]...
+ *  MATCH <id> <>                                    -> MATCHED <status> [<>]...
+ *  TEXT <id>                                              -> TEXT <> (   )
+ *                                                   -> ERROR <>
+ * status - ACTUAL, IRRELEVANT, BANNED  REMOVED.
+ *
+ *    ,   :     .
+ *       epoll   
+ * ( ,     SO_REUSEPORT). , 
+ *   ,   ,    FIND, MATCH  TEXT -  
+ * ,   ProcessQueries.         
+ * max_output_size,        .
+ *
+ *  SearchServer search_server("and in on"sv);
+ *  NetworkServer network_server(search_server, { 8080 });
+ *  network_server.Start();
+ */
+class NetworkServer {
+public:
+    //   ,     Start;  - system_error
+    explicit NetworkServer(SearchServer& search_server, const NetworkServerConfig& config = {});
+    ~NetworkServer();
+
+    NetworkServer(const NetworkServer&) = delete;
+    NetworkServer& operator=(const NetworkServer&) = delete;
+
+    uint16_t GetPort() const;
+
+    //      
+    void Start();
+
+    //   ;     
+    void Stop();
+
+    //     ;      
+    std::string HandleRequest(std::string_view request);
+
+private:
+    class EventLoop;
+
+    SearchServer& search_server_;
+    // FIND, MATCH  TEXT  , ADD, UPDATE  REMOVE - 
+    std::shared_mutex search_server_mutex_;
+
+    NetworkServerConfig config_;
+    uint16_t port_ = 0;
+
+    std::vector<std::unique_ptr<EventLoop>> loops_;
+    std::vector<std::thread> threads_;
+
+private:
+    friend class EventLoop;
+
+    //    ; responses[i] -   requests[i]
+    void HandleRequests(const std::vector<std::string_view>& requests, std::vector<std::string>& responses);
+
+    std::string HandleReadRequest(std::string_view request) const;
+    std::string HandleWriteRequest(std::string_view request);
+};
+
+#endif
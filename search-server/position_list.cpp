@@ -0,0 +1,23 @@
+#include "position_list.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+void PositionList::Add(uint32_t position) {
+    if (count_ > 0 && position <= last_position_)
+    {
+        throw invalid_argument("Positions must be added in increasing order"s);
+    }
+
+    uint32_t delta = position - last_position_;
+    while (delta >= 0x80) {
+        bytes_.push_back(static_cast<uint8_t>(delta | 0x80));
+        delta >>= 7;
+    }
+    bytes_.push_back(static_cast<uint8_t>(delta));
+
+    last_position_ = position;
+    ++count_;
+}
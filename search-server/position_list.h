@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+/**
+ *      .
+ *
+ *    ;    
+ *   varint (7   ,   -  ),
+ *       .  
+ *   .      .
+ */
+class PositionList {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<uint8_t>;
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = uint32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const uint32_t*;
+        using reference = const uint32_t&;
+
+        Iterator() = default;
+
+        Iterator(const uint8_t* data, const uint8_t* end)
+            : data_(data), end_(end) {
+            Decode();
+        }
+
+        reference operator*() const {
+            return position_;
+        }
+
+        Iterator& operator++() {
+            Decode();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs.next_ == rhs.next_;
+        }
+
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+    private:
+        //     
+        const uint8_t* data_ = nullptr;
+        const uint8_t* end_ = nullptr;
+        //     ; nullptr -  
+        const uint8_t* next_ = nullptr;
+        uint32_t position_ = 0;
+
+        void Decode() {
+            if (data_ == end_)
+            {
+                next_ = nullptr;
+                return;
+            }
+
+            uint32_t delta = 0;
+            for (int shift = 0; ; shift += 7) {
+                const uint8_t byte = *data_++;
+                delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                {
+                    break;
+                }
+            }
+            position_ += delta;
+            next_ = data_;
+        }
+    };
+
+    PositionList() = default;
+
+    explicit PositionList(const allocator_type& alloc)
+        : bytes_(alloc) {
+    }
+
+    PositionList(const PositionList& other, const allocator_type& alloc)
+        : bytes_(other.bytes_, alloc), last_position_(other.last_position_), count_(other.count_) {
+    }
+
+    PositionList(PositionList&& other, const allocator_type& alloc)
+        : bytes_(std::move(other.bytes_), alloc), last_position_(other.last_position_), count_(other.count_) {
+    }
+
+    allocator_type get_allocator() const {
+        return bytes_.get_allocator();
+    }
+
+    // position      
+    void Add(uint32_t position);
+
+    //  
+    size_t size() const {
+        return count_;
+    }
+
+    //    
+    size_t GetEncodedSize() const {
+        return bytes_.size();
+    }
+
+    void ShrinkToFit() {
+        bytes_.shrink_to_fit();
+    }
+
+    Iterator begin() const {
+        return Iterator(bytes_.data(), bytes_.data() + bytes_.size());
+    }
+
+    Iterator end() const {
+        return Iterator();
+    }
+
+private:
+    std::pmr::vector<uint8_t> bytes_;
+    uint32_t last_position_ = 0;
+    uint32_t count_ = 0;
+};
@@ -0,0 +1,49 @@
+#include "rating_index.h"
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+using namespace std;
+
+RatingIndex::RatingIndex(const allocator_type& alloc)
+    : entries_(alloc) {
+}
+
+void RatingIndex::Add(int document_id, int rating) {
+    entries_.emplace(rating, document_id);
+}
+
+void RatingIndex::Remove(int document_id, int rating) {
+    entries_.erase({ rating, document_id });
+}
+
+void RatingIndex::Update(int document_id, int old_rating, int new_rating) {
+    if (old_rating == new_rating)
+    {
+        return;
+    }
+    //        
+    auto node = entries_.extract({ old_rating, document_id });
+    node.value().first = new_rating;
+    entries_.insert(move(node));
+}
+
+size_t RatingIndex::GetSize() const {
+    return entries_.size();
+}
+
+bool RatingIndex::CollectAtLeast(int min_rating, size_t max_count, vector<int>& sorted_ids) const {
+    sorted_ids.clear();
+    //      min_rating
+    const auto last = min_rating == INT_MIN ? entries_.end() : entries_.lower_bound({ min_rating - 1, INT_MIN });
+    for (auto it = entries_.begin(); it != last; ++it) {
+        if (sorted_ids.size() == max_count)
+        {
+            return false;
+        }
+        sorted_ids.push_back(it->second);
+    }
+    sort(sorted_ids.begin(), sorted_ids.end());
+    return true;
+}
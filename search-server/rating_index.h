@@ -0,0 +1,64 @@
+#pragma once
+
+#include "memory_stats.h"
+
+#include <cstddef>
+#include <memory_resource>
+#include <set>
+#include <utility>
+#include <vector>
+
+/**
+ *    .
+ *
+ *     ,    -   id,
+ *        -  ,    
+ *     .      .
+ */
+class RatingIndex {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    explicit RatingIndex(const allocator_type& alloc = {});
+
+    void Add(int document_id, int rating);
+    void Remove(int document_id, int rating);
+    //        old_rating
+    void Update(int document_id, int old_rating, int new_rating);
+
+    size_t GetSize() const;
+
+    // id      min_rating  ;   
+    //  max_count,  false,   sorted_ids  
+    bool CollectAtLeast(int min_rating, size_t max_count, std::vector<int>& sorted_ids) const;
+
+    // callback(document_id, rating)       min_rating  
+    // ,    id,  callback  true
+    template <typename Callback>
+    void ForEachAtLeast(int min_rating, Callback callback) const;
+
+    //     
+    static constexpr size_t GetEntrySize() {
+        return GetSetNodeSize<std::pair<int, int>>();
+    }
+
+private:
+    // (rating, id)   ,    id
+    struct RatingOrder {
+        bool operator()(const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) const {
+            return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+        }
+    };
+
+    std::pmr::set<std::pair<int, int>, RatingOrder> entries_;
+};
+
+template <typename Callback>
+void RatingIndex::ForEachAtLeast(int min_rating, Callback callback) const {
+    for (const auto& [rating, document_id] : entries_) {
+        if (rating < min_rating || !callback(document_id, rating))
+        {
+            return;
+        }
+    }
+}
@@ -1,52 +1,76 @@
 #include "remove_duplicates.h"
 
 #include <vector>
-#include <set>
 #include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <iostream>
 #include <iterator>
+#include <execution>
+#include <functional>
+#include <cstdint>
 
 using namespace std;
 
-// id      
-struct DocumentUniqueWords {
-    int document_id;
-    set<string_view> unique_words;
-};
+// 64-    ;        
+static uint64_t ComputeWordsSignature(const WordFrequencies& words_freqs) {
+    const hash<string_view> hasher;
+    uint64_t signature = words_freqs.size();
+    for (const auto& [word, freq] : words_freqs) {
+        signature ^= hasher(word) + 0x9e3779b97f4a7c15ull + (signature << 6) + (signature >> 2);
+    }
+    return signature;
+}
 
-//   DocumentUniqueWords    std::set
-bool operator<(const DocumentUniqueWords& lhv, const DocumentUniqueWords& rhv) {
-    return make_pair(lhv.document_id, lhv.unique_words) < make_pair(rhv.document_id, rhv.unique_words);
+//       
+static bool HasSameWords(const WordFrequencies& lhs, const WordFrequencies& rhs) {
+    return lhs.size() == rhs.size()
+        && equal(lhs.begin(), lhs.end(), rhs.begin(),
+            [](const auto& lhs_word_freq, const auto& rhs_word_freq) {
+                return lhs_word_freq.first == rhs_word_freq.first;
+            });
 }
 
 //    (   )
+//         id
 void RemoveDuplicates(SearchServer& search_server)
 {
-    //   (id)     
-    set<DocumentUniqueWords> docs_unique_words;
-    
-    for (size_t i = 0; i < search_server.GetDocumentCount(); ) {
-        int document_id = *(next(search_server.begin(), i));
-        set<string_view> current_doc_unique_words;
+    const vector<int> documents_id(search_server.begin(), search_server.end());
+
+    //     
+    vector<uint64_t> signatures(documents_id.size());
+    transform(execution::par, documents_id.begin(), documents_id.end(), signatures.begin(),
+        [&search_server](int document_id) {
+            return ComputeWordsSignature(search_server.GetWordFrequencies(document_id));
+        });
+
+    //  -> id     
+    unordered_map<uint64_t, vector<int>> unique_documents;
+    unique_documents.reserve(documents_id.size());
+
+    vector<int> duplicates_id;
+
+    // id   ,         id
+    for (size_t i = 0; i < documents_id.size(); ++i) {
+        const int document_id = documents_id[i];
         const auto& doc_freqs = search_server.GetWordFrequencies(document_id);
+        vector<int>& same_signature_documents = unique_documents[signatures[i]];
 
-        for (const auto& [word, freq] : doc_freqs) {
-            current_doc_unique_words.insert(word);
+        if (any_of(same_signature_documents.begin(), same_signature_documents.end(),
+            [&](int unique_document_id) {
+                return HasSameWords(search_server.GetWordFrequencies(unique_document_id), doc_freqs);
+            }))
+        {
+            duplicates_id.push_back(document_id);
         }
-
-		if (any_of(docs_unique_words.begin(), docs_unique_words.end(),
-			[current_doc_unique_words](const DocumentUniqueWords& d) {
-				return (d.unique_words == current_doc_unique_words);
-			}))
-		{
-			cout << "Found duplicate document id "s << document_id << endl;
-			search_server.RemoveDocument(document_id);
-		}
         else
         {
-            docs_unique_words.insert({ document_id, current_doc_unique_words });
-            ++i;
+            same_signature_documents.push_back(document_id);
         }
     }
-}
\ No newline at end of file
+
+    for (const int document_id : duplicates_id) {
+        cout << "Found duplicate document id "s << document_id << endl;
+    }
+    search_server.RemoveDocuments(execution::par, duplicates_id);
+}
@@ -1,47 +1,118 @@
 #include "request_queue.h"
 
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
 using namespace std;
 
-RequestQueue::RequestQueue(const SearchServer& search_server)
-    : server_(search_server) {
+//  :     ,    8
+static size_t GetShardsCount() {
+    return clamp<size_t>(thread::hardware_concurrency(), 1, 8);
+}
+
+RequestQueue::RequestQueue(const SearchServer& search_server, chrono::seconds window, chrono::seconds slot_duration)
+    : server_(search_server)
+    , slot_duration_(slot_duration)
+    , shards_(GetShardsCount()) {
 
+    if (slot_duration.count() <= 0 || window < slot_duration)
+    {
+        throw invalid_argument("Request window must contain at least one positive time slot"s);
+    }
+
+    const size_t slots_count = static_cast<size_t>(window / slot_duration);
+    for (Shard& shard : shards_) {
+        shard.slots.resize(slots_count);
+    }
 }
 
 vector<Document> RequestQueue::AddFindRequest(const string& raw_query, DocumentStatus status) {
-    QueryResult query_result;
+    const auto start_time = Clock::now();
     auto documents = server_.FindTopDocuments(raw_query, status);
-    query_result.documents_count = documents.size();
-    ProcessQueryResult(query_result);
+    RecordRequest(documents.size(), Clock::now() - start_time);
 
     return documents;
 }
 
 vector<Document> RequestQueue::AddFindRequest(const string& raw_query) {
-    QueryResult query_result;
+    const auto start_time = Clock::now();
     auto documents = server_.FindTopDocuments(raw_query);
-    query_result.documents_count = documents.size();
-    ProcessQueryResult(query_result);
+    RecordRequest(documents.size(), Clock::now() - start_time);
 
     return documents;
 }
 
 int RequestQueue::GetNoResultRequests() const {
-    return static_cast<int>(null_result_count_);
+    return static_cast<int>(GetStats().no_result_count);
 }
 
-bool RequestQueue::QueryResult::IsNullRequest() const {
-    return documents_count == 0;
+RequestStats RequestQueue::GetStats() const {
+    return GetStats(chrono::duration_cast<chrono::seconds>(slot_duration_ * shards_.front().slots.size()));
 }
 
-void RequestQueue::ProcessQueryResult(const QueryResult& query_result) {
-    requests_.push_back(query_result);
-    if (query_result.IsNullRequest()) {
-        ++null_result_count_;
-    }
-    if (requests_.size() > min_in_day_) {
-        if (requests_.front().IsNullRequest()) {
-            --null_result_count_;
+RequestStats RequestQueue::GetStats(chrono::seconds window) const {
+    const size_t slots_count = shards_.front().slots.size();
+    const size_t window_slots = clamp<size_t>(static_cast<size_t>((window + slot_duration_ - Clock::duration(1)) / slot_duration_), 1, slots_count);
+    const int64_t last_slot = GetSlotNumber(Clock::now());
+    const int64_t first_slot = last_slot - static_cast<int64_t>(window_slots) + 1;
+
+    RequestStats stats;
+    LatencyHistogram latencies;
+
+    for (const Shard& shard : shards_) {
+        lock_guard guard(shard.mutex);
+        for (const TimeSlot& slot : shard.slots) {
+            if (slot.slot_number >= first_slot && slot.slot_number <= last_slot)
+            {
+                stats.requests_count += slot.requests_count;
+                stats.no_result_count += slot.no_result_count;
+                latencies.Merge(slot.latencies);
+            }
         }
-        requests_.pop_front();
     }
+
+    const double window_seconds = chrono::duration<double>(slot_duration_ * window_slots).count();
+    stats.queries_per_second = stats.requests_count / window_seconds;
+    stats.no_result_rate = stats.requests_count ? static_cast<double>(stats.no_result_count) / stats.requests_count : 0.;
+    stats.latency_p50 = latencies.GetPercentile(0.5);
+    stats.latency_p90 = latencies.GetPercentile(0.9);
+    stats.latency_p99 = latencies.GetPercentile(0.99);
+    stats.latency_max = latencies.GetMax();
+
+    return stats;
+}
+
+void RequestQueue::RecordRequest(size_t documents_count, Clock::duration latency) {
+    const int64_t slot_number = GetSlotNumber(Clock::now());
+    Shard& shard = GetThreadShard();
+
+    lock_guard guard(shard.mutex);
+    TimeSlot& slot = shard.slots[static_cast<size_t>(slot_number) % shard.slots.size()];
+
+    // ,     , 
+    if (slot.slot_number != slot_number)
+    {
+        slot.slot_number = slot_number;
+        slot.requests_count = 0;
+        slot.no_result_count = 0;
+        slot.latencies.Clear();
+    }
+
+    ++slot.requests_count;
+    if (documents_count == 0)
+    {
+        ++slot.no_result_count;
+    }
+    slot.latencies.Record(chrono::duration_cast<LatencyHistogram::Duration>(latency));
+}
+
+int64_t RequestQueue::GetSlotNumber(Clock::time_point time) const {
+    return static_cast<int64_t>(time.time_since_epoch() / slot_duration_);
+}
+
+RequestQueue::Shard& RequestQueue::GetThreadShard() {
+    thread_local const size_t thread_hash = hash<thread::id>{}(this_thread::get_id());
+    return shards_[thread_hash % shards_.size()];
 }
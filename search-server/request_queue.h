@@ -1,46 +1,87 @@
 #pragma once
 
 #include "search_server.h"
+#include "latency_histogram.h"
 
-#include <deque>
+#include <chrono>
+#include <mutex>
+#include <vector>
 
+//     
+struct RequestStats {
+    uint64_t requests_count = 0;
+    uint64_t no_result_count = 0;
+    double queries_per_second = 0.;
+    double no_result_rate = 0.;
+    std::chrono::nanoseconds latency_p50{};
+    std::chrono::nanoseconds latency_p90{};
+    std::chrono::nanoseconds latency_p99{};
+    std::chrono::nanoseconds latency_max{};
+};
+
+/**
+ *        .
+ *
+ *      slot_duration.      
+ * (     ),    
+ *  ,          .
+ */
 class RequestQueue {
 public:
-    explicit RequestQueue(const SearchServer& search_server);
+    using Clock = std::chrono::steady_clock;
+
+    explicit RequestQueue(const SearchServer& search_server,
+        std::chrono::seconds window = std::chrono::hours(24),
+        std::chrono::seconds slot_duration = std::chrono::minutes(1));
 
-    // ""    ,     
+    // ""    ,     
     template <typename DocumentPredicate>
     std::vector<Document> AddFindRequest(const std::string& raw_query, DocumentPredicate document_predicate);
     std::vector<Document> AddFindRequest(const std::string& raw_query, DocumentStatus status);
     std::vector<Document> AddFindRequest(const std::string& raw_query);
 
+    //       
     int GetNoResultRequests() const;
 
-private:
-    struct QueryResult {
-        size_t documents_count = 0;
+    //    window (   )
+    RequestStats GetStats(std::chrono::seconds window) const;
+    RequestStats GetStats() const;
 
-        bool IsNullRequest() const;
-    };
+    //  ,    AddFindRequest
+    void RecordRequest(size_t documents_count, Clock::duration latency);
 
-    const static int min_in_day_ = 1440;
+private:
+    //    
+    struct TimeSlot {
+        //       ; -1 -  
+        int64_t slot_number = -1;
+        uint64_t requests_count = 0;
+        uint64_t no_result_count = 0;
+        LatencyHistogram latencies;
+    };
 
-    std::deque<QueryResult> requests_;
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::vector<TimeSlot> slots;
+    };
 
     const SearchServer& server_;
 
-    size_t null_result_count_ = 0;
+    const Clock::duration slot_duration_;
+
+    std::vector<Shard> shards_;
 
 private:
-    void ProcessQueryResult(const QueryResult& query_result);
+    int64_t GetSlotNumber(Clock::time_point time) const;
+
+    Shard& GetThreadShard();
 };
 
 template <typename DocumentPredicate>
 std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query, DocumentPredicate document_predicate) {
-    QueryResult query_result{};
+    const auto start_time = Clock::now();
     auto documents = server_.FindTopDocuments(raw_query, document_predicate);
-    query_result.documents_count = documents.size();
-    ProcessQueryResult(query_result);
+    RecordRequest(documents.size(), Clock::now() - start_time);
 
     return documents;
 }
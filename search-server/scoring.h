@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+//     ;        
+struct CorpusStats {
+    size_t documents_count = 0;
+    //      -
+    size_t words_count = 0;
+
+    double GetAverageDocumentLength() const {
+        return documents_count > 0 ? static_cast<double>(words_count) / documents_count : 0.;
+    }
+};
+
+//  ,     -   ;
+// ,   ,  IDF      
+class CorpusStatsSource {
+public:
+    virtual ~CorpusStatsSource() = default;
+
+    virtual const CorpusStats& GetCorpusStats() const = 0;
+
+    //      
+    virtual size_t GetDocumentFrequency(std::string_view word) const = 0;
+
+    // callback(term, distance, document_freq)        max_distance
+    //   word; false -    ,      
+    virtual bool ForEachWordWithinDistance(std::string_view /*word*/, uint32_t /*max_distance*/,
+        const std::function<void(std::string_view, uint32_t, size_t)>& /*callback*/) const {
+        return false;
+    }
+};
+
+/**
+ *   -   FindTopDocuments.
+ *
+ * ComputeIdf      , MakeKernel -    :
+ *       .    
+ *          .
+ */
+
+// TF-IDF: tf * log(N / df)
+struct TfIdfScoring {
+    struct Kernel {
+        double operator()(double idf, double term_freq, double /*document_length*/) const {
+            return idf * term_freq;
+        }
+    };
+
+    double ComputeIdf(const CorpusStats& stats, size_t document_freq) const {
+        return std::log(static_cast<double>(stats.documents_count) / document_freq);
+    }
+
+    Kernel MakeKernel(const CorpusStats& /*stats*/) const {
+        return {};
+    }
+};
+
+// Okapi BM25
+struct Bm25Scoring {
+    double k1 = 1.2;
+    double b = 0.75;
+
+    struct Kernel {
+        double k1_plus_one = 0.;
+        // : count + length_base + length_factor * |D|,  length_base = k1 * (1 - b),
+        // length_factor = k1 * b / avgdl
+        double length_base = 0.;
+        double length_factor = 0.;
+
+        double operator()(double idf, double term_freq, double document_length) const {
+            //   TF,    ,  BM25   
+            const double count = term_freq * document_length;
+            return idf * count * k1_plus_one / (count + length_base + length_factor * document_length);
+        }
+    };
+
+    double ComputeIdf(const CorpusStats& stats, size_t document_freq) const {
+        const double documents_count = static_cast<double>(stats.documents_count);
+        return std::log(1. + (documents_count - document_freq + 0.5) / (document_freq + 0.5));
+    }
+
+    Kernel MakeKernel(const CorpusStats& stats) const {
+        const double average_length = stats.GetAverageDocumentLength();
+        return { k1 + 1., k1 * (1. - b), average_length > 0. ? k1 * b / average_length : 0. };
+    }
+};
@@ -34,6 +34,18 @@ size_t SearchServer::GetDocumentCount() const {
     return documents_data_.size();
 }
 
+const CorpusStats& SearchServer::GetCorpusStats() const {
+    return corpus_stats_;
+}
+
+void SearchServer::SetCorpusStatsSource(const CorpusStatsSource* source) {
+    corpus_stats_source_ = source;
+}
+
+const CorpusStats& SearchServer::GetScoringStats() const {
+    return corpus_stats_source_ ? corpus_stats_source_->GetCorpusStats() : corpus_stats_;
+}
+
 void SearchServer::AddDocument(int document_id, std::string_view document, DocumentStatus status, const vector<int>& ratings) {
 
     //      id
@@ -54,33 +66,204 @@ void SearchServer::AddDocument(int document_id, std::string_view document, Docum
         throw invalid_argument("Document text contains special characters"s);
     }
 
-    vector<string_view> document_words = SplitIntoWordsNoStop(document);
-    vector<set<string>::iterator> doc_words_ptrs;
-
     added_documents_id_.insert(document_id);
-    auto document_rating = ComputeAverageRating(ratings);
-    documents_data_[document_id] = { status, document_rating };
 
     DocumentData& cur_doc_data = documents_data_[document_id];
+    cur_doc_data.status = status;
+    cur_doc_data.rating = ComputeAverageRating(ratings);
+    rating_index_.Add(document_id, cur_doc_data.rating);
+    auto& document_words_freqs = document_to_words_freqs_[document_id];
+
+    //        ,     TF;
+    //      ,      
+    size_t document_words_count = 0u;
+    for (const string_view word : SplitIntoWordsNoStop(document)) {
+        const auto term = word_to_documents_freqs_.Insert(word).first;
+        document_words_freqs[term.term] += 1.;
+        if (positional_index_enabled_)
+        {
+            cur_doc_data.words_positions[term.term].Add(static_cast<uint32_t>(document_words_count));
+        }
+        ++document_words_count;
+    }
+
+    for (auto& [word, positions] : cur_doc_data.words_positions) {
+        positions.ShrinkToFit();
+    }
+
+    cur_doc_data.words_count = document_words_count;
+    ++corpus_stats_.documents_count;
+    corpus_stats_.words_count += document_words_count;
+
+    for (auto& [word, term_freq] : document_words_freqs) {
+        term_freq /= document_words_count;
+        (*word_to_documents_freqs_.Find(word))[document_id] = term_freq;
+    }
+
+    memory_stats_ += ComputeDocumentMemory(document_id);
+
+    if (memory_budget_ > 0 && GetMemoryStats().GetTotal() + EstimateStoredTextSize(document) > memory_budget_)
+    {
+        //        :     
+        RemoveDocument(document_id);
 
-    for (const auto& word : document_words) {
-        cur_doc_data.words_data.insert(static_cast<string>(word));
-        doc_words_ptrs.push_back(cur_doc_data.words_data.find(word));
+        throw length_error("Memory budget exceeded"s);
+    }
+
+    if (document_store_config_.enabled)
+    {
+        document_store_.Add(document_id, document);
     }
+}
 
-    double freq_increase = 1. / document_words.size();
+void SearchServer::UpdateDocument(int document_id, string_view document, DocumentStatus status, const vector<int>& ratings) {
 
-    for (const auto& word_ptr : doc_words_ptrs) {
-        word_to_documents_freqs_[*word_ptr][document_id] += freq_increase;
-        document_to_words_freqs_[document_id][*word_ptr] += freq_increase;
+    if (!documents_data_.count(document_id))
+    {
+        throw out_of_range("No document with given id"s);
+    }
+
+    //    
+    if (!IsValidText(document))
+    {
+        throw invalid_argument("Document text contains special characters"s);
+    }
+
+    //          
+    vector<string_view> old_words;
+    bool old_positions = false;
+    DocumentStatus old_status = DocumentStatus::ACTUAL;
+    int old_rating = 0;
+    if (memory_budget_ > 0)
+    {
+        const DocumentData& document_data = documents_data_.at(document_id);
+        old_words = GetDocumentWords(document_id);
+        old_positions = !document_data.words_positions.empty();
+        old_status = document_data.status;
+        old_rating = document_data.rating;
+    }
+
+    memory_stats_ -= ComputeDocumentMemory(document_id);
+
+    vector<string_view> new_words;
+    vector<string_view> words;
+    for (const string_view word : SplitIntoWordsNoStop(document)) {
+        const auto [term, inserted] = word_to_documents_freqs_.Insert(word);
+        if (inserted)
+        {
+            new_words.push_back(term.term);
+        }
+        words.push_back(term.term);
+    }
+    const vector<string_view> emptied_words = UpdateDocumentWords(document_id, words, positional_index_enabled_);
+    SetDocumentMetadata(document_id, status, ComputeAverageRating(ratings));
+
+    memory_stats_ += ComputeDocumentMemory(document_id);
+
+    //       ,    
+    if (memory_budget_ > 0 && GetMemoryStats().GetTotal() + EstimateStoredTextSize(document) > memory_budget_)
+    {
+        memory_stats_ -= ComputeDocumentMemory(document_id);
+        UpdateDocumentWords(document_id, old_words, old_positions);
+        SetDocumentMetadata(document_id, old_status, old_rating);
+        memory_stats_ += ComputeDocumentMemory(document_id);
+
+        //       
+        for (const string_view word : new_words) {
+            word_to_documents_freqs_.Erase(word);
+        }
+
+        throw length_error("Memory budget exceeded"s);
+    }
+
+    // ,       ,      :
+    //         
+    for (const string_view word : emptied_words) {
+        word_to_documents_freqs_.Erase(word);
+    }
+
+    document_store_.Remove(document_id);
+    if (document_store_config_.enabled)
+    {
+        document_store_.Add(document_id, document);
+    }
+}
+
+void SearchServer::UpdateDocumentMetadata(int document_id, DocumentStatus status, const vector<int>& ratings) {
+    if (!documents_data_.count(document_id))
+    {
+        throw out_of_range("No document with given id"s);
     }
+    SetDocumentMetadata(document_id, status, ComputeAverageRating(ratings));
 }
 
 void SearchServer::SetStopWords(const string_view text) {
-    for (const string_view word : SplitIntoWords(text))
+    stop_words_.Insert(SplitIntoWords(text));
+}
+
+void SearchServer::SetPositionalIndex(bool enabled) {
+    positional_index_enabled_ = enabled;
+}
+
+bool SearchServer::IsPositionalIndexEnabled() const {
+    return positional_index_enabled_;
+}
+
+void SearchServer::SetFuzzyMatching(const FuzzyMatching& fuzzy_matching) {
+    if (fuzzy_matching.max_edits > 2)
+    {
+        throw invalid_argument("Fuzzy matching supports at most 2 edits"s);
+    }
+    if (!(fuzzy_matching.weight > 0. && fuzzy_matching.weight <= 1.))
     {
-        stop_words_.insert(static_cast<string>(word));
+        throw invalid_argument("Fuzzy match weight must be in (0, 1]"s);
     }
+    fuzzy_matching_ = fuzzy_matching;
+}
+
+const FuzzyMatching& SearchServer::GetFuzzyMatching() const {
+    return fuzzy_matching_;
+}
+
+void SearchServer::SetDocumentStore(const DocumentStoreConfig& config) {
+    document_store_config_ = config;
+    document_store_.SetConfig(config);
+}
+
+const DocumentStoreConfig& SearchServer::GetDocumentStore() const {
+    return document_store_config_;
+}
+
+string SearchServer::GetDocumentText(int document_id) const {
+    return document_store_.GetText(document_id);
+}
+
+vector<string> SearchServer::GetDocumentTexts(const vector<int>& document_ids) const {
+    return document_store_.GetTexts(document_ids);
+}
+
+void SearchServer::SetExecutionThresholds(const ExecutionThresholds& thresholds) {
+    execution_thresholds_ = thresholds;
+}
+
+const ExecutionThresholds& SearchServer::GetExecutionThresholds() const {
+    return execution_thresholds_;
+}
+
+MemoryStats SearchServer::GetMemoryStats() const {
+    MemoryStats stats = memory_stats_;
+    stats.stop_words = stop_words_.GetMemoryUsage();
+    stats.word_to_documents_freqs += word_to_documents_freqs_.GetMemoryUsage();
+    stats.document_texts = document_store_.GetMemoryUsage();
+    return stats;
+}
+
+void SearchServer::SetMemoryBudget(size_t bytes) {
+    memory_budget_ = bytes;
+}
+
+size_t SearchServer::GetMemoryBudget() const {
+    return memory_budget_;
 }
 
 vector<Document> SearchServer::FindTopDocuments(const string_view raw_query, DocumentStatus required_status) const {
@@ -94,6 +277,198 @@ vector<Document> SearchServer::FindTopDocuments(const string_view raw_query) con
     return FindTopDocuments(raw_query, DocumentStatus::ACTUAL);
 }
 
+vector<Document> SearchServer::FindTopDocumentsWithMinRating(const string_view raw_query, int min_rating,
+    DocumentStatus required_status) const {
+
+    {
+        TRACE_SPAN("FindTopDocumentsWithMinRating");
+        const ActiveQueryScope active_query;
+
+        const Query parsed_query = ParseQuery(raw_query);
+
+        size_t postings_count = 0;
+        for (const auto& word_postings : LookupPostings(parsed_query, TfIdfScoring())) {
+            postings_count += word_postings.postings->size();
+        }
+
+        vector<int> sorted_ids;
+        if (rating_index_.CollectAtLeast(min_rating, postings_count, sorted_ids))
+        {
+            vector<Document> documents = ScoreDocumentsAmong(parsed_query, sorted_ids, required_status);
+            const size_t count = min(documents.size(), static_cast<size_t>(MAX_RESULT_DOCUMENT_COUNT));
+            partial_sort(documents.begin(), documents.begin() + count, documents.end(), RanksHigher);
+            documents.resize(count);
+            return documents;
+        }
+    }
+
+    //     ,  :      
+    return FindTopDocuments(raw_query,
+        [required_status, min_rating](int, DocumentStatus status, int rating) {
+            return status == required_status && rating >= min_rating;
+        });
+}
+
+vector<Document> SearchServer::FindTopRatedDocuments(const string_view raw_query, int min_rating,
+    DocumentStatus required_status) const {
+
+    TRACE_SPAN("FindTopRatedDocuments");
+    const ActiveQueryScope active_query;
+
+    const Query parsed_query = ParseQuery(raw_query);
+    const TfIdfScoring scoring;
+    const auto plus_words_postings = LookupPostings(parsed_query, scoring);
+    const auto minus_words_postings = LookupMinusPostings(parsed_query);
+
+    size_t postings_count = 0;
+    size_t max_postings_count = 0;
+    for (const auto& word_postings : plus_words_postings) {
+        postings_count += word_postings.postings->size();
+        max_postings_count = max(max_postings_count, word_postings.postings->size());
+    }
+    if (postings_count == 0)
+    {
+        return {};
+    }
+
+    const size_t result_count = static_cast<size_t>(MAX_RESULT_DOCUMENT_COUNT);
+    //      result_count * ( /    )
+    //         ;  -   
+    const size_t walk_cost = result_count * (GetDocumentCount() / max_postings_count + 1)
+        * (plus_words_postings.size() + minus_words_postings.size());
+
+    vector<Document> documents;
+    if (walk_cost < postings_count)
+    {
+        const auto score = scoring.MakeKernel(GetScoringStats());
+        rating_index_.ForEachAtLeast(min_rating, [&](int document_id, int rating) {
+            //  ,      
+            if (documents.size() >= result_count && rating < documents.back().rating)
+            {
+                return false;
+            }
+            for (const Postings* postings : minus_words_postings) {
+                if (postings->count(document_id))
+                {
+                    return true;
+                }
+            }
+
+            const DocumentData* document_data = nullptr;
+            double relevance = 0.;
+            for (const auto& [word_idf, postings] : plus_words_postings) {
+                const auto posting = postings->find(document_id);
+                if (posting == postings->end())
+                {
+                    continue;
+                }
+                if (document_data == nullptr)
+                {
+                    document_data = &documents_data_.at(document_id);
+                    if (document_data->status != required_status)
+                    {
+                        return true;
+                    }
+                }
+                relevance += score(word_idf, posting->second, document_data->words_count);
+            }
+
+            if (document_data != nullptr && MatchesPhrases(parsed_query, document_id))
+            {
+                documents.push_back({ document_id, relevance, rating });
+            }
+            return true;
+            });
+    }
+    else
+    {
+        const auto document_to_relevance = ComputeDocumentsRelevance(parsed_query,
+            [required_status, min_rating](int, DocumentStatus status, int rating) {
+                return status == required_status && rating >= min_rating;
+            }, scoring);
+        documents.reserve(document_to_relevance.size());
+        for (const auto& [document_id, relevance] : document_to_relevance) {
+            documents.push_back({ document_id, relevance, documents_data_.at(document_id).rating });
+        }
+    }
+
+    TRACE_SPAN("SortTopDocuments");
+    const size_t count = min(documents.size(), result_count);
+    partial_sort(documents.begin(), documents.begin() + count, documents.end(), RatedHigher);
+    documents.resize(count);
+    return documents;
+}
+
+vector<Document> SearchServer::ScoreDocumentsAmong(const Query& parsed_query, const vector<int>& sorted_ids,
+    DocumentStatus required_status) const {
+
+    TRACE_SPAN("ScoreDocumentsAmong");
+
+    if (sorted_ids.empty())
+    {
+        return {};
+    }
+
+    const TfIdfScoring scoring;
+    const auto score = scoring.MakeKernel(GetScoringStats());
+
+    //         
+    vector<const DocumentData*> documents_data(sorted_ids.size(), nullptr);
+    vector<double> relevance(sorted_ids.size(), 0.);
+    vector<char> has_minus_word(sorted_ids.size(), 0);
+
+    for (const Postings* postings : LookupMinusPostings(parsed_query)) {
+        ForEachPostedDocument(*postings, sorted_ids, 0, sorted_ids.size(), [&](size_t i, double) {
+            has_minus_word[i] = 1;
+            });
+    }
+    for (const auto& [word_idf, postings] : LookupPostings(parsed_query, scoring)) {
+        ForEachPostedDocument(*postings, sorted_ids, 0, sorted_ids.size(), [&, word_idf = word_idf](size_t i, double term_freq) {
+            if (has_minus_word[i])
+            {
+                return;
+            }
+            if (documents_data[i] == nullptr)
+            {
+                documents_data[i] = &documents_data_.at(sorted_ids[i]);
+            }
+            relevance[i] += score(word_idf, term_freq, documents_data[i]->words_count);
+            });
+    }
+
+    vector<Document> documents;
+    for (size_t i = 0; i < sorted_ids.size(); ++i) {
+        if (documents_data[i] != nullptr && documents_data[i]->status == required_status
+            && MatchesPhrases(parsed_query, sorted_ids[i]))
+        {
+            documents.push_back({ sorted_ids[i], relevance[i], documents_data[i]->rating });
+        }
+    }
+    return documents;
+}
+
+void SearchServer::FindTopDocuments(const string_view raw_query, DocumentStatus required_status, vector<Document>& result) const {
+
+    FindTopDocuments(raw_query,
+        [required_status](int, DocumentStatus doc_status, int)
+        {return doc_status == required_status; }, result);
+}
+
+void SearchServer::FindTopDocuments(const string_view raw_query, vector<Document>& result) const {
+    FindTopDocuments(raw_query, DocumentStatus::ACTUAL, result);
+}
+
+DocumentsPage SearchServer::FindTopDocumentsPage(const string_view raw_query, DocumentStatus required_status, const PageRequest& page) const {
+
+    return FindTopDocumentsPage(raw_query,
+        [required_status](int, DocumentStatus doc_status, int)
+        {return doc_status == required_status; }, page);
+}
+
+DocumentsPage SearchServer::FindTopDocumentsPage(const string_view raw_query, const PageRequest& page) const {
+    return FindTopDocumentsPage(raw_query, DocumentStatus::ACTUAL, page);
+}
+
 //     - ,      
 //      (   -   -),       
 MatchDocumentData SearchServer::MatchDocument(const string_view raw_query, int document_id) const {
@@ -103,6 +478,8 @@ MatchDocumentData SearchServer::MatchDocument(const string_view raw_query, int d
         throw out_of_range("No document with given id"s);
     }
 
+    const ActiveQueryScope active_query;
+
 	vector<string_view> matched_plus_words;
 
 	Query parsed_query = ParseQuery(raw_query);
@@ -110,16 +487,27 @@ MatchDocumentData SearchServer::MatchDocument(const string_view raw_query, int d
     const auto& words_freqs = GetWordFrequencies(document_id);
 
     for (const string_view word : parsed_query.minus_words) {
-        if (words_freqs.count(static_cast<string>(word))) {
-            return { {}, documents_data_.at(document_id).status };
+        if (words_freqs.count(word)) {
+            return { vector<string_view>{}, documents_data_.at(document_id).status };
         }
     }
 
+    if (!MatchesPhrases(parsed_query, document_id))
+    {
+        return { vector<string_view>{}, documents_data_.at(document_id).status };
+    }
+
 	for (const string_view word : parsed_query.plus_words) {
-        if (words_freqs.count(static_cast<string>(word))) {
+        if (words_freqs.count(word)) {
             matched_plus_words.push_back(word);
         }
 	}
+    for (const auto& [word, weight] : parsed_query.fuzzy_words) {
+        if (words_freqs.count(word))
+        {
+            matched_plus_words.push_back(word);
+        }
+    }
 
 	return { matched_plus_words, documents_data_.at(document_id).status };
 }
@@ -137,46 +525,69 @@ MatchDocumentData SearchServer::MatchDocument
         throw out_of_range("No document with given id"s);
     }
 
+    const ActiveQueryScope active_query;
+
     Query parsed_query = ParseQuery(raw_query, false);
 
     const auto& words_freqs = GetWordFrequencies(document_id);
 
     auto contains_minus_word = any_of(execution::par, parsed_query.minus_words.begin(), parsed_query.minus_words.end(),
         [&](const string_view word) {
-            return words_freqs.count(static_cast<string>(word));
+            return words_freqs.count(word);
         });
 
-    if (contains_minus_word) {
-        return { {}, documents_data_.at(document_id).status };
+    if (contains_minus_word || !MatchesPhrases(parsed_query, document_id)) {
+        return { vector<string_view>{}, documents_data_.at(document_id).status };
     }
 
     vector<string_view> matched_plus_words;
     matched_plus_words.resize(parsed_query.plus_words.size());
     auto last = copy_if(execution::par, parsed_query.plus_words.begin(), parsed_query.plus_words.end(), matched_plus_words.begin(),
         [&](const string_view word) {
-            return words_freqs.count(static_cast<string>(word));
+            return words_freqs.count(word);
         });
 
     std::sort(matched_plus_words.begin(), last);
     auto last_2 = std::unique(matched_plus_words.begin(), last);
     matched_plus_words.resize(distance(matched_plus_words.begin(), last_2));
     //matched_plus_words.erase(last_2, matched_plus_words.end());
+
+    //      -   
+    for (const auto& [word, weight] : parsed_query.fuzzy_words) {
+        if (words_freqs.count(word))
+        {
+            matched_plus_words.push_back(word);
+        }
+    }
     
     return { matched_plus_words, documents_data_.at(document_id).status };
 }
 
-std::set<int>::const_iterator SearchServer::begin() const {
+MatchDocumentData SearchServer::MatchDocument
+(const AutoExecutionPolicy&, const string_view raw_query, int document_id) const {
+    //  -       
+    const WordRange query_words = SplitIntoWords(raw_query);
+    const size_t words_count = distance(query_words.begin(), query_words.end());
+
+    if (PlanExecution({ words_count, words_count }) == ExecutionMode::SEQUENTIAL)
+    {
+        return MatchDocument(execution::seq, raw_query, document_id);
+    }
+    return MatchDocument(execution::par, raw_query, document_id);
+}
+
+std::pmr::set<int>::const_iterator SearchServer::begin() const {
     return added_documents_id_.cbegin();
 }
 
-std::set<int>::const_iterator SearchServer::end() const {
+std::pmr::set<int>::const_iterator SearchServer::end() const {
     return added_documents_id_.cend();
 }
 
 //     id 
-const map<string_view, double>& SearchServer::GetWordFrequencies(int document_id) const
+const WordFrequencies& SearchServer::GetWordFrequencies(int document_id) const
 {
-    static const map<string_view, double> NULL_RESULT;
+    static const WordFrequencies NULL_RESULT;
 
     if (document_to_words_freqs_.count(document_id))
     {
@@ -186,94 +597,123 @@ const map<string_view, double>& SearchServer::GetWordFrequencies(int document_id
     return NULL_RESULT;
 }
 
-void SearchServer::RemoveDocument(int document_id)
+vector<pair<string_view, size_t>> SearchServer::GetQueryDocumentFrequencies(string_view raw_query) const
 {
-    if (!added_documents_id_.count(document_id))
-    {
-        return;
-    }
-
-    //  id 
-    added_documents_id_.erase(document_id);
+    const Query parsed_query = ParseQuery(raw_query);
 
-    //       
-    documents_data_.erase(documents_data_.find(document_id));
-    
-    //     ,  id      word_to_documents_freqs_
-    for (auto& [word, term_freq] : document_to_words_freqs_[document_id]) {
-        word_to_documents_freqs_[word].erase(document_id);
+    vector<pair<string_view, size_t>> documents_freqs;
+    documents_freqs.reserve(parsed_query.plus_words.size() + parsed_query.fuzzy_words.size());
+    for (const string_view plus_word : parsed_query.plus_words) {
+        const Postings* postings = word_to_documents_freqs_.Find(plus_word);
+        documents_freqs.push_back({ plus_word, postings == nullptr ? 0 : postings->size() });
     }
+    for (const auto& [fuzzy_word, weight] : parsed_query.fuzzy_words) {
+        //         
+        const Postings* postings = word_to_documents_freqs_.Find(fuzzy_word);
+        documents_freqs.push_back({ fuzzy_word, postings == nullptr ? 0 : postings->size() });
+    }
+    return documents_freqs;
+}
 
-    //          
-    document_to_words_freqs_.erase(document_id);
+void SearchServer::RemoveDocument(int document_id)
+{
+    RemoveDocumentsBatch({ document_id }, false);
 }
 
 void SearchServer::RemoveDocument(const std::execution::sequenced_policy&, int document_id)
 {
-    RemoveDocument(document_id);
+    RemoveDocumentsBatch({ document_id }, false);
+}
+
+void SearchServer::RemoveDocument(const std::execution::parallel_policy&, int document_id)
+{
+    RemoveDocumentsBatch({ document_id }, true);
 }
 
-void SearchServer::RemoveDocument(const std::execution::parallel_policy& policy, int document_id)
+void SearchServer::RemoveDocument(const AutoExecutionPolicy&, int document_id)
 {
+    //  -       
+    const size_t words_count = GetWordFrequencies(document_id).size();
 
-    if (!added_documents_id_.count(document_id))
+    if (PlanExecution({ words_count, words_count }) == ExecutionMode::SEQUENTIAL)
     {
-        return;
+        RemoveDocument(execution::seq, document_id);
     }
+    else
+    {
+        RemoveDocument(execution::par, document_id);
+    }
+}
 
-    //  id 
-    added_documents_id_.erase(document_id);
-
-    //       
-    documents_data_.erase(documents_data_.find(document_id));
-
-    std::vector<std::string_view> keys;
-    //words_ptr.reserve(document_to_words_freqs_[document_id].size());
-    keys.resize(document_to_words_freqs_[document_id].size());
-
-    std::transform(std::execution::par,
-        document_to_words_freqs_[document_id].begin(), document_to_words_freqs_[document_id].end(), keys.begin(),
-        [](const std::pair<const std::string_view, double>& p) -> std::string_view {
-            return p.first;
-        });
+void SearchServer::RemoveDocuments(const vector<int>& document_ids)
+{
+    RemoveDocumentsBatch(document_ids, false);
+}
 
-	std::for_each(std::execution::par,
-		keys.begin(),
-		keys.end(),
-		[&](const std::string_view key)
-		{
-			if (word_to_documents_freqs_.count(key) > 0)
-			{
-				word_to_documents_freqs_[key].erase(document_id);
-			}
-		});
+void SearchServer::RemoveDocuments(const std::execution::sequenced_policy&, const vector<int>& document_ids)
+{
+    RemoveDocumentsBatch(document_ids, false);
+}
 
-    //          
-    document_to_words_freqs_.erase(document_id);
+void SearchServer::RemoveDocuments(const std::execution::parallel_policy&, const vector<int>& document_ids)
+{
+    RemoveDocumentsBatch(document_ids, true);
 }
 
-bool SearchServer::IsStopWord(const string_view word) const {
-    return (stop_words_.count(word) > 0);
+void SearchServer::RemoveDocuments(const AutoExecutionPolicy&, const vector<int>& document_ids)
+{
+    //  -     
+    size_t postings_count = 0;
+    for (const int document_id : document_ids) {
+        const auto words_freqs_it = document_to_words_freqs_.find(document_id);
+        if (words_freqs_it != document_to_words_freqs_.end())
+        {
+            postings_count += words_freqs_it->second.size();
+        }
+    }
+
+    RemoveDocumentsBatch(document_ids, PlanExecution({ postings_count, postings_count }) != ExecutionMode::SEQUENTIAL);
 }
 
-std::vector<std::string_view> SearchServer::SplitIntoWordsNoStop(const std::string_view text) const {
-    vector<string_view> words;
+void SearchServer::MoveDocument(int document_id, SearchServer& target)
+{
+    if (!documents_data_.count(document_id))
+    {
+        throw out_of_range("No document with given id"s);
+    }
+    if (&target == this)
+    {
+        return;
+    }
 
-    auto pos = text.find_first_not_of(' ');
-    auto pos_end = text.npos;
+    const DocumentData& document_data = documents_data_.at(document_id);
 
-    while (pos != pos_end)
+    if (document_store_.Contains(document_id))
     {
-        auto space = text.find(' ', pos);
-        string_view word = space == pos_end ? text.substr(pos) : text.substr(pos, space - pos);
-        if (!IsStopWord(word))
+        target.AddDocument(document_id, document_store_.GetText(document_id), document_data.status, { document_data.rating });
+        RemoveDocument(document_id);
+        return;
+    }
+
+    string text;
+    for (const string_view word : GetDocumentWords(document_id)) {
+        if (!text.empty())
         {
-            words.push_back(word);
+            text += ' ';
         }
-        pos = text.find_first_not_of(' ', space);
+        text += word;
     }
 
-    return words;
+    target.AddDocument(document_id, text, document_data.status, { document_data.rating });
+    RemoveDocument(document_id);
+}
+
+bool SearchServer::IsStopWord(const string_view word) const {
+    return stop_words_.Contains(word);
+}
+
+SearchServer::WordsNoStopRange SearchServer::SplitIntoWordsNoStop(const std::string_view text) const {
+    return FilterWords(SplitIntoWords(text), NotStopWord{ this });
 }
 
 bool SearchServer::IsValidText(const string_view text) const {
@@ -318,14 +758,247 @@ void SearchServer::ParseQueryWord(const string_view word, Query& query) const {
             throw invalid_argument("Query contains double dash"s);
         }
 
-        if (!IsStopWord(no_prefix_word))
+        if (IsPrefixWord(no_prefix_word))
+        {
+            ExpandPrefixWord(no_prefix_word, query.minus_words);
+        }
+        else if (!IsStopWord(no_prefix_word))
         {
             query.minus_words.push_back(no_prefix_word);
         }
     }
+    else if (IsPrefixWord(word))
+    {
+        ExpandPrefixWord(word, query.plus_words);
+    }
     else if (!IsStopWord(word))
     {
         query.plus_words.push_back(word);
+        //    :          
+        if (fuzzy_matching_.max_edits > 0 && word.size() >= fuzzy_matching_.min_word_length)
+        {
+            //     ,       
+            const Postings* postings = word_to_documents_freqs_.Find(word);
+            const bool is_missing = corpus_stats_source_ != nullptr
+                ? corpus_stats_source_->GetDocumentFrequency(word) == 0
+                : postings == nullptr || postings->empty();
+            if (is_missing)
+            {
+                ExpandFuzzyWord(word, query);
+            }
+        }
+    }
+}
+
+bool SearchServer::IsPrefixWord(const string_view word) {
+    return word.size() > 1 && word.back() == '*';
+}
+
+void SearchServer::ExpandPrefixWord(const string_view word, vector<string_view>& words) const {
+    //      ,     
+    word_to_documents_freqs_.ForEachWithPrefix(word.substr(0, word.size() - 1),
+        [&](const string_view term, const Postings& postings) {
+            if (!postings.empty() && !IsStopWord(term))
+            {
+                words.push_back(term);
+            }
+        });
+}
+
+void SearchServer::ExpandFuzzyWord(const string_view word, Query& query) const {
+
+    if (query.fuzzy_words.size() >= fuzzy_matching_.max_expansions)
+    {
+        return;
+    }
+
+    struct Candidate {
+        uint32_t distance;
+        size_t document_freq;
+        string_view word;
+    };
+    vector<Candidate> candidates;
+    const auto add_candidate = [&](const string_view term, uint32_t distance, size_t document_freq) {
+        if (document_freq > 0 && !IsStopWord(term))
+        {
+            candidates.push_back({ distance, document_freq, term });
+        }
+    };
+    //        ,      ;
+    //     ,   
+    if (corpus_stats_source_ == nullptr
+        || !corpus_stats_source_->ForEachWordWithinDistance(word, fuzzy_matching_.max_edits, add_candidate))
+    {
+        word_to_documents_freqs_.ForEachWithinDistance(word, fuzzy_matching_.max_edits,
+            [&](const string_view term, uint32_t distance, const Postings& postings) {
+                add_candidate(term, distance, postings.size());
+            });
+    }
+
+    //    -     ,   
+    const size_t count = min(candidates.size(), fuzzy_matching_.max_expansions - query.fuzzy_words.size());
+    partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+        [](const Candidate& lhs, const Candidate& rhs) {
+            return tie(lhs.distance, rhs.document_freq, lhs.word) < tie(rhs.distance, lhs.document_freq, rhs.word);
+        });
+    for (size_t i = 0; i < count; ++i) {
+        query.fuzzy_words.push_back({ candidates[i].word, pow(fuzzy_matching_.weight, candidates[i].distance) });
+    }
+}
+
+bool SearchServer::StartsPhrase(const string_view word) {
+    return (!word.empty() && word[0] == '"') || (word.size() > 1 && word[0] == '-' && word[1] == '"');
+}
+
+void SearchServer::ParsePhrase(WordIterator& word_it, const WordIterator words_end, Query& query) const {
+
+    if (!positional_index_enabled_)
+    {
+        throw invalid_argument("Phrase queries require positional index"s);
+    }
+
+    string_view word = *word_it;
+    const bool is_minus_phrase = MatchedAsMinusWord(word);
+    //   (   )
+    word.remove_prefix(is_minus_phrase ? 2 : 1);
+
+    Phrase phrase;
+    while (true) {
+        if (!IsValidText(word))
+        {
+            throw invalid_argument("Query contains special characters"s);
+        }
+
+        const size_t quote_pos = word.find('"');
+        const string_view phrase_word = word.substr(0, quote_pos);
+        if (!phrase_word.empty() && !IsStopWord(phrase_word))
+        {
+            phrase.words.push_back(phrase_word);
+        }
+
+        if (quote_pos != word.npos)
+        {
+            //      ~N -       
+            const string_view suffix = word.substr(quote_pos + 1);
+            if (!suffix.empty())
+            {
+                if (suffix.size() < 2 || suffix.size() > 10 || suffix[0] != '~'
+                    || !all_of(suffix.begin() + 1, suffix.end(), [](char c) { return c >= '0' && c <= '9'; }))
+                {
+                    throw invalid_argument("Invalid proximity after phrase"s);
+                }
+                phrase.slop = static_cast<uint32_t>(stoul(string(suffix.substr(1))));
+            }
+            break;
+        }
+
+        ++word_it;
+        if (word_it == words_end)
+        {
+            throw invalid_argument("Phrase is not closed"s);
+        }
+        word = *word_it;
+    }
+
+    //    -   
+    if (phrase.words.empty())
+    {
+        return;
+    }
+
+    if (is_minus_phrase)
+    {
+        query.minus_phrases.push_back(move(phrase));
+    }
+    else
+    {
+        query.plus_words.insert(query.plus_words.end(), phrase.words.begin(), phrase.words.end());
+        query.phrases.push_back(move(phrase));
+    }
+}
+
+bool SearchServer::MatchesPhrase(const DocumentData& document_data, const Phrase& phrase) {
+
+    // ,       
+    vector<uint32_t> prefix_ends;
+    vector<uint32_t> next_prefix_ends;
+
+    for (size_t i = 0; i < phrase.words.size(); ++i) {
+        const auto positions_it = document_data.words_positions.find(phrase.words[i]);
+        if (positions_it == document_data.words_positions.end())
+        {
+            return false;
+        }
+        const PositionList& positions = positions_it->second;
+
+        if (i == 0)
+        {
+            prefix_ends.assign(positions.begin(), positions.end());
+            continue;
+        }
+
+        // :           slop 
+        next_prefix_ends.clear();
+        auto prefix_end = prefix_ends.begin();
+        for (const uint32_t position : positions) {
+            while (prefix_end != prefix_ends.end() && *prefix_end + 1 + phrase.slop < position) {
+                ++prefix_end;
+            }
+            if (prefix_end == prefix_ends.end())
+            {
+                break;
+            }
+            if (*prefix_end < position)
+            {
+                next_prefix_ends.push_back(position);
+            }
+        }
+
+        if (next_prefix_ends.empty())
+        {
+            return false;
+        }
+        prefix_ends.swap(next_prefix_ends);
+    }
+
+    return !prefix_ends.empty();
+}
+
+bool SearchServer::MatchesPhrases(const Query& parsed_query, int document_id) const {
+
+    if (parsed_query.phrases.empty() && parsed_query.minus_phrases.empty())
+    {
+        return true;
+    }
+
+    const DocumentData& document_data = documents_data_.at(document_id);
+    return all_of(parsed_query.phrases.begin(), parsed_query.phrases.end(),
+        [&](const Phrase& phrase) {
+            return MatchesPhrase(document_data, phrase);
+        })
+        && none_of(parsed_query.minus_phrases.begin(), parsed_query.minus_phrases.end(),
+            [&](const Phrase& phrase) {
+                return MatchesPhrase(document_data, phrase);
+            });
+}
+
+void SearchServer::FilterByPhrases(const Query& parsed_query, map<int, double>& document_to_relevance) const {
+
+    if (parsed_query.phrases.empty() && parsed_query.minus_phrases.empty())
+    {
+        return;
+    }
+
+    TRACE_SPAN("FilterByPhrases");
+    for (auto it = document_to_relevance.begin(); it != document_to_relevance.end();) {
+        if (MatchesPhrases(parsed_query, it->first))
+        {
+            ++it;
+        }
+        else
+        {
+            it = document_to_relevance.erase(it);
+        }
     }
 }
 
@@ -333,11 +1006,31 @@ void SearchServer::ParseQueryWord(const string_view word, Query& query) const {
 //    ,       
 //   ,  erase_duplicates = false
 SearchServer::Query SearchServer::ParseQuery(const string_view text, const bool erase_duplicates) const {
-
     Query query;
+    ParseQuery(text, query, erase_duplicates);
+    return query;
+}
+
+void SearchServer::ParseQuery(const string_view text, Query& query, const bool erase_duplicates) const {
+
+    TRACE_SPAN("ParseQuery");
 
-    for (const string_view word : SplitIntoWords(text)) {
-        ParseQueryWord(word, query);
+    query.plus_words.clear();
+    query.minus_words.clear();
+    query.phrases.clear();
+    query.minus_phrases.clear();
+    query.fuzzy_words.clear();
+
+    const WordRange words = SplitIntoWords(text);
+    for (auto word_it = words.begin(); word_it != words.end(); ++word_it) {
+        if (StartsPhrase(*word_it))
+        {
+            ParsePhrase(word_it, words.end(), query);
+        }
+        else
+        {
+            ParseQueryWord(*word_it, query);
+        }
     }
 
     if (erase_duplicates)
@@ -353,7 +1046,362 @@ SearchServer::Query SearchServer::ParseQuery(const string_view text, const bool
         //query.plus_words.erase(p_last, query.plus_words.end());
     }
 
-    return query;
+    if (!query.fuzzy_words.empty())
+    {
+        // ,   ,    ;
+        //  ,     -,   -
+        std::sort(query.fuzzy_words.begin(), query.fuzzy_words.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.first != rhs.first ? lhs.first < rhs.first : lhs.second > rhs.second;
+            });
+        auto f_last = std::unique(query.fuzzy_words.begin(), query.fuzzy_words.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.first == rhs.first;
+            });
+        f_last = std::remove_if(query.fuzzy_words.begin(), f_last,
+            [&](const auto& fuzzy_word) {
+                return find(query.plus_words.begin(), query.plus_words.end(), fuzzy_word.first) != query.plus_words.end();
+            });
+        query.fuzzy_words.erase(f_last, query.fuzzy_words.end());
+    }
+}
+
+vector<const Postings*> SearchServer::LookupMinusPostings(const Query& parsed_query) const {
+
+    vector<const Postings*> minus_words_postings;
+    minus_words_postings.reserve(parsed_query.minus_words.size());
+    LookupMinusPostings(parsed_query, minus_words_postings);
+    return minus_words_postings;
+}
+
+void SearchServer::LookupMinusPostings(const Query& parsed_query, vector<const Postings*>& minus_words_postings) const {
+
+    minus_words_postings.clear();
+    for (const string_view minus_word : parsed_query.minus_words) {
+        const Postings* postings = word_to_documents_freqs_.Find(minus_word);
+        if (postings != nullptr && !postings->empty())
+        {
+            minus_words_postings.push_back(postings);
+        }
+    }
+}
+
+SearchServer::QueryScratch& SearchServer::GetThreadQueryScratch() {
+    thread_local QueryScratch scratch;
+    return scratch;
+}
+
+bool SearchServer::RatedHigher(const Document& lhs, const Document& rhs) {
+    if (lhs.rating != rhs.rating)
+    {
+        return lhs.rating > rhs.rating;
+    }
+    if (abs(lhs.relevance - rhs.relevance) >= EPSILON)
+    {
+        return lhs.relevance > rhs.relevance;
+    }
+    return lhs.id < rhs.id;
+}
+
+bool SearchServer::RanksHigher(const Document& lhs, const Document& rhs) {
+    if (abs(lhs.relevance - rhs.relevance) >= EPSILON)
+    {
+        return lhs.relevance > rhs.relevance;
+    }
+    if (lhs.rating != rhs.rating)
+    {
+        return lhs.rating > rhs.rating;
+    }
+    return lhs.id < rhs.id;
+}
+
+DocumentsPage SearchServer::SelectPage(const map<int, double>& document_to_relevance, const PageRequest& page) const {
+
+    TRACE_SPAN("SelectPage");
+
+    //  ,   count     
+    const size_t heap_limit = page.count > numeric_limits<size_t>::max() - page.offset
+        ? numeric_limits<size_t>::max()
+        : page.offset + page.count;
+
+    //    ;    -   ,    
+    vector<Document> heap;
+    heap.reserve(min(heap_limit, document_to_relevance.size()));
+
+    //      -   ,    
+    size_t after_cursor_count = 0;
+
+    for (const auto& [document_id, relevance] : document_to_relevance) {
+        //     -    
+        if (page.after && relevance - page.after->relevance >= EPSILON)
+        {
+            continue;
+        }
+        //     -    
+        if (heap.size() == heap_limit && heap.front().relevance - relevance >= EPSILON)
+        {
+            ++after_cursor_count;
+            continue;
+        }
+
+        const Document document(document_id, relevance, GetDocumentRating(document_id));
+        if (page.after && !RanksHigher(*page.after, document))
+        {
+            continue;
+        }
+
+        ++after_cursor_count;
+        if (heap.size() < heap_limit)
+        {
+            heap.push_back(document);
+            push_heap(heap.begin(), heap.end(), RanksHigher);
+        }
+        else if (RanksHigher(document, heap.front()))
+        {
+            pop_heap(heap.begin(), heap.end(), RanksHigher);
+            heap.back() = document;
+            push_heap(heap.begin(), heap.end(), RanksHigher);
+        }
+    }
+
+    sort_heap(heap.begin(), heap.end(), RanksHigher);
+
+    DocumentsPage result;
+    if (heap.size() > page.offset)
+    {
+        result.documents.assign(heap.begin() + page.offset, heap.end());
+    }
+    if (after_cursor_count > heap_limit && !result.documents.empty())
+    {
+        result.next = result.documents.back();
+    }
+
+    return result;
+}
+
+ExecutionMode SearchServer::PlanExecution(const ExecutionCost& cost) const {
+    return ChooseExecutionMode(cost, execution_thresholds_, GetActiveQueriesCount());
+}
+
+void SearchServer::EraseDocumentData(int document_id) {
+    const auto document_data_it = documents_data_.find(document_id);
+    rating_index_.Remove(document_id, document_data_it->second.rating);
+    --corpus_stats_.documents_count;
+    corpus_stats_.words_count -= document_data_it->second.words_count;
+    documents_data_.erase(document_data_it);
+}
+
+void SearchServer::RemoveDocumentsBatch(const vector<int>& document_ids, bool parallel) {
+
+    //       id
+    vector<int> removed_ids;
+    removed_ids.reserve(document_ids.size());
+    for (const int document_id : document_ids) {
+        if (added_documents_id_.count(document_id))
+        {
+            removed_ids.push_back(document_id);
+        }
+    }
+    sort(removed_ids.begin(), removed_ids.end());
+    removed_ids.erase(unique(removed_ids.begin(), removed_ids.end()), removed_ids.end());
+    if (removed_ids.empty())
+    {
+        return;
+    }
+
+    // ,   :  (, ),   ;  
+    //  ,      
+    vector<pair<string_view, int>> word_documents;
+    for (const int document_id : removed_ids) {
+        memory_stats_ -= ComputeDocumentMemory(document_id);
+        for (const auto& [word, term_freq] : document_to_words_freqs_.at(document_id)) {
+            word_documents.emplace_back(word, document_id);
+        }
+    }
+    sort(word_documents.begin(), word_documents.end(), [](const pair<string_view, int>& lhs, const pair<string_view, int>& rhs) {
+        return lhs.first.data() != rhs.first.data() ? lhs.first.data() < rhs.first.data() : lhs.second < rhs.second;
+        });
+
+    //    
+    vector<size_t> group_begins;
+    for (size_t i = 0; i < word_documents.size(); ++i) {
+        if (i == 0 || word_documents[i].first.data() != word_documents[i - 1].first.data())
+        {
+            group_begins.push_back(i);
+        }
+    }
+    const size_t groups_count = group_begins.size();
+    group_begins.push_back(word_documents.size());
+
+    //       ,   ,  
+    //    ;      
+    vector<char> emptied(groups_count, 0);
+    const auto remove_group = [&](size_t group) {
+        Postings& postings = *word_to_documents_freqs_.Find(word_documents[group_begins[group]].first);
+        for (size_t i = group_begins[group]; i < group_begins[group + 1]; ++i) {
+            postings.erase(word_documents[i].second);
+        }
+        emptied[group] = postings.empty();
+    };
+    vector<size_t> groups(groups_count);
+    iota(groups.begin(), groups.end(), 0);
+    if (parallel)
+    {
+        for_each(execution::par, groups.begin(), groups.end(), remove_group);
+    }
+    else
+    {
+        for_each(groups.begin(), groups.end(), remove_group);
+    }
+
+    for (const int document_id : removed_ids) {
+        added_documents_id_.erase(document_id);
+        EraseDocumentData(document_id);
+        document_store_.Remove(document_id);
+        document_to_words_freqs_.erase(document_id);
+    }
+
+    //       :        
+    for (size_t group = 0; group < groups_count; ++group) {
+        if (emptied[group])
+        {
+            word_to_documents_freqs_.Erase(word_documents[group_begins[group]].first);
+        }
+    }
+}
+
+vector<string_view> SearchServer::UpdateDocumentWords(int document_id, const vector<string_view>& words, bool record_positions) {
+    DocumentData& document_data = documents_data_.at(document_id);
+    WordFrequencies& document_words_freqs = document_to_words_freqs_.at(document_id);
+
+    //      ;      
+    bool positions_changed = record_positions != !document_data.words_positions.empty() || document_data.words_count != words.size();
+    for (auto word_it = document_data.words_positions.begin(); !positions_changed && word_it != document_data.words_positions.end(); ++word_it) {
+        for (const uint32_t position : word_it->second) {
+            if (words[position] != word_it->first)
+            {
+                positions_changed = true;
+                break;
+            }
+        }
+    }
+
+    //       ;       
+    vector<string_view> sorted_words(words);
+    sort(sorted_words.begin(), sorted_words.end());
+
+    vector<string_view> emptied_words;
+    auto freq_it = document_words_freqs.begin();
+    size_t i = 0;
+    while (i < sorted_words.size() || freq_it != document_words_freqs.end()) {
+        //     
+        if (i == sorted_words.size() || (freq_it != document_words_freqs.end() && freq_it->first < sorted_words[i]))
+        {
+            Postings& postings = *word_to_documents_freqs_.Find(freq_it->first);
+            postings.erase(document_id);
+            if (postings.empty())
+            {
+                emptied_words.push_back(freq_it->first);
+            }
+            freq_it = document_words_freqs.erase(freq_it);
+            continue;
+        }
+
+        const string_view word = sorted_words[i];
+        size_t word_count = 0;
+        for (; i < sorted_words.size() && sorted_words[i] == word; ++i) {
+            ++word_count;
+        }
+        const double term_freq = static_cast<double>(word_count) / static_cast<double>(words.size());
+
+        if (freq_it != document_words_freqs.end() && freq_it->first == word)
+        {
+            //    ,   
+            if (freq_it->second != term_freq)
+            {
+                freq_it->second = term_freq;
+                word_to_documents_freqs_.Find(word)->at(document_id) = term_freq;
+            }
+            ++freq_it;
+        }
+        else
+        {
+            document_words_freqs.emplace_hint(freq_it, word, term_freq);
+            word_to_documents_freqs_.Find(word)->emplace(document_id, term_freq);
+        }
+    }
+
+    if (positions_changed)
+    {
+        document_data.words_positions.clear();
+        if (record_positions)
+        {
+            for (size_t position = 0; position < words.size(); ++position) {
+                document_data.words_positions[words[position]].Add(static_cast<uint32_t>(position));
+            }
+            for (auto& [word, positions] : document_data.words_positions) {
+                positions.ShrinkToFit();
+            }
+        }
+    }
+
+    corpus_stats_.words_count = corpus_stats_.words_count - document_data.words_count + words.size();
+    document_data.words_count = words.size();
+
+    return emptied_words;
+}
+
+void SearchServer::SetDocumentMetadata(int document_id, DocumentStatus status, int rating) {
+    DocumentData& document_data = documents_data_.at(document_id);
+    rating_index_.Update(document_id, document_data.rating, rating);
+    document_data.rating = rating;
+    document_data.status = status;
+}
+
+vector<string_view> SearchServer::GetDocumentWords(int document_id) const {
+    const DocumentData& document_data = documents_data_.at(document_id);
+
+    vector<string_view> words;
+    if (!document_data.words_positions.empty())
+    {
+        words.resize(document_data.words_count);
+        for (const auto& [word, positions] : document_data.words_positions) {
+            for (const uint32_t position : positions) {
+                words[position] = word;
+            }
+        }
+    }
+    else
+    {
+        for (const auto& [word, term_freq] : document_to_words_freqs_.at(document_id)) {
+            words.insert(words.end(), static_cast<size_t>(llround(term_freq * document_data.words_count)), word);
+        }
+    }
+    return words;
+}
+
+MemoryStats SearchServer::ComputeDocumentMemory(int document_id) const {
+    MemoryStats stats;
+    stats.documents_ids = GetSetNodeSize<int>();
+
+    const auto& words_freqs = document_to_words_freqs_.at(document_id);
+    stats.document_to_words_freqs = GetMapNodeSize<int, WordFrequencies>()
+        + words_freqs.size() * GetMapNodeSize<string_view, double>();
+    //       
+    stats.word_to_documents_freqs = words_freqs.size() * GetMapNodeSize<int, double>();
+
+    const DocumentData& document_data = documents_data_.at(document_id);
+    stats.documents_data = GetMapNodeSize<int, DocumentData>() + RatingIndex::GetEntrySize()
+        + document_data.words_positions.size() * GetMapNodeSize<string_view, PositionList>();
+    for (const auto& [word, positions] : document_data.words_positions) {
+        stats.documents_data += positions.GetEncodedSize();
+    }
+
+    return stats;
+}
+
+size_t SearchServer::EstimateStoredTextSize(string_view document) const {
+    return document_store_config_.enabled ? document.size() : 0;
 }
 
 int SearchServer::ComputeAverageRating(const vector<int>& ratings) {
@@ -411,8 +1459,10 @@ void MatchDocuments(const SearchServer& search_server, const string& query) {
     try {
         cout << "   : "s << query << endl;
 
+        const auto matches = search_server.MatchDocuments(execution::par, query, search_server);
+        auto match = matches.begin();
         for (const auto document_id : search_server) {
-            const auto [words, status] = search_server.MatchDocument(query, document_id);
+            const auto& [words, status] = *match++;
             PrintMatchDocumentResult(document_id, words, status);
         }
     }
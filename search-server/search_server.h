@@ -2,26 +2,82 @@
 
 #include "document.h"
 #include "string_processing.h"
+#include "stop_words.h"
 #include "concurrent_map.h"
 #include "read_input_functions.h"
-
+#include "trace.h"
+#include "execution_planner.h"
+#include "position_list.h"
+#include "scoring.h"
+#include "memory_stats.h"
+#include "term_dictionary.h"
+#include "rating_index.h"
+#include "document_store.h"
+
+#include <cstdint>
 #include <string>
 #include <stdexcept>
 #include <vector>
 #include <map>
 #include <set>
+#include <memory>
+#include <memory_resource>
 #include <cmath>
 #include <algorithm>
+#include <numeric>
 #include <execution>
 #include <string_view>
 #include <mutex>
+#include <optional>
+#include <limits>
+#include <thread>
+#include <type_traits>
 
 const int MAX_RESULT_DOCUMENT_COUNT = 5;
 
 const double EPSILON = 1e-6;
 
+//    ,    MatchDocuments
+const size_t MATCH_DOCUMENTS_CHUNK_SIZE = 256;
+
+//   : word -> TF
+using WordFrequencies = std::pmr::map<std::string_view, double>;
+
+//  : document_id -> TF
+using Postings = std::pmr::map<int, double>;
+
 using MatchDocumentData = std::tuple<std::vector<std::string_view>, DocumentStatus>;
 
+//    
+struct PageRequest {
+    //    
+    size_t count = MAX_RESULT_DOCUMENT_COUNT;
+    //   ;      
+    size_t offset = 0;
+    //     (, , id);    
+    std::optional<Document> after;
+};
+
+//   : - ,    ,      
+struct FuzzyMatching {
+    //       (  2); 0 -    
+    uint32_t max_edits = 0;
+    //     
+    size_t min_word_length = 4;
+    //        ;   
+    // ,    
+    size_t max_expansions = 16;
+    //       ,  (0, 1]
+    double weight = 0.5;
+};
+
+//   
+struct DocumentsPage {
+    std::vector<Document> documents;
+    //     ; ,    
+    std::optional<Document> next;
+};
+
 class SearchServer {
 
 public:
@@ -30,15 +86,68 @@ public:
     explicit SearchServer(const StringCollection& stop_words);
     explicit SearchServer(const std::string& stop_words_text);
     explicit SearchServer(const std::string_view stop_words_text);
+    template<size_t N>
+    explicit SearchServer(const StaticStopWords<N>& stop_words);
 
     SearchServer() = default;
 
+    //       ,   
+    SearchServer(SearchServer&& other) = default;
+    SearchServer& operator=(SearchServer&& other) = delete;
+
     size_t GetDocumentCount() const;
 
+    //         
+    const CorpusStats& GetCorpusStats() const;
+
+    //  ,    ,   -   ;
+    // nullptr -   .    
+    void SetCorpusStatsSource(const CorpusStatsSource* source);
+
     void AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings);
 
+    //  ,    ;    ,  
+    // .   - out_of_range;     
+    //       length_error
+    void UpdateDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings);
+    //     ,   ;   - out_of_range
+    void UpdateDocumentMetadata(int document_id, DocumentStatus status, const std::vector<int>& ratings);
+
 	void SetStopWords(const std::string_view text);
 
+    //     ,   ;     :
+    // "curly cat" -  , "curly cat"~2 -      2 , -"curly cat" -  
+    // -   
+    void SetPositionalIndex(bool enabled);
+    bool IsPositionalIndexEnabled() const;
+
+    //   - invalid_argument
+    void SetFuzzyMatching(const FuzzyMatching& fuzzy_matching);
+    const FuzzyMatching& GetFuzzyMatching() const;
+
+    //    ,   ,   
+    void SetDocumentStore(const DocumentStoreConfig& config);
+    const DocumentStoreConfig& GetDocumentStore() const;
+
+    //   ; out_of_range,    
+    std::string GetDocumentText(int document_id) const;
+    //     document_ids; out_of_range,  -   
+    std::vector<std::string> GetDocumentTexts(const std::vector<int>& document_ids) const;
+
+    // ,   auto_execution   
+    void SetExecutionThresholds(const ExecutionThresholds& thresholds);
+    const ExecutionThresholds& GetExecutionThresholds() const;
+
+    // ,  ,  
+    MemoryStats GetMemoryStats() const;
+
+    //     , 0 -  ; AddDocument,  
+    //    ,    length_error
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const;
+
+    //  ,   '*', - : cur*      ,
+    //   cur (       ), -cur*  
 	template <typename Requirement>
 	std::vector<Document> FindTopDocuments(const std::string_view raw_query, Requirement requirement) const;
 	template <typename Policy, typename Requirement>
@@ -49,69 +158,300 @@ public:
 	std::vector<Document> FindTopDocuments(const std::string_view raw_query) const;
 	template <typename Policy>
 	std::vector<Document> FindTopDocuments(const Policy& policy, const std::string_view raw_query) const;
+	//     (TfIdfScoring, Bm25Scoring);    TF-IDF
+	template <typename Policy, typename Requirement, typename Scoring>
+	std::vector<Document> FindTopDocuments(const Policy& policy, const std::string_view raw_query, Requirement requirement, const Scoring& scoring) const;
+	template <typename Policy, typename Scoring>
+	std::vector<Document> FindTopDocuments(const Policy& policy, const std::string_view raw_query, DocumentStatus required_status, const Scoring& scoring) const;
+
+	//         (result );
+	//  ,        ,
+	//   ,         
+	template <typename Requirement, typename Scoring = TfIdfScoring>
+	void FindTopDocuments(const std::string_view raw_query, Requirement requirement, std::vector<Document>& result, const Scoring& scoring = Scoring()) const;
+	void FindTopDocuments(const std::string_view raw_query, DocumentStatus required_status, std::vector<Document>& result) const;
+	void FindTopDocuments(const std::string_view raw_query, std::vector<Document>& result) const;
+
+	//  :   ,    offset + count 
+	//  ,        
+	template <typename Requirement>
+	DocumentsPage FindTopDocumentsPage(const std::string_view raw_query, Requirement requirement, const PageRequest& page) const;
+	template <typename Policy, typename Requirement>
+	DocumentsPage FindTopDocumentsPage(const Policy& policy, const std::string_view raw_query, Requirement requirement, const PageRequest& page) const;
+	DocumentsPage FindTopDocumentsPage(const std::string_view raw_query, DocumentStatus required_status, const PageRequest& page) const;
+	template <typename Policy>
+	DocumentsPage FindTopDocumentsPage(const Policy& policy, const std::string_view raw_query, DocumentStatus required_status, const PageRequest& page) const;
+	DocumentsPage FindTopDocumentsPage(const std::string_view raw_query, const PageRequest& page) const;
+	template <typename Policy>
+	DocumentsPage FindTopDocumentsPage(const Policy& policy, const std::string_view raw_query, const PageRequest& page) const;
+	template <typename Policy, typename Requirement, typename Scoring>
+	DocumentsPage FindTopDocumentsPage(const Policy& policy, const std::string_view raw_query, Requirement requirement, const PageRequest& page, const Scoring& scoring) const;
+	template <typename Policy, typename Scoring>
+	DocumentsPage FindTopDocumentsPage(const Policy& policy, const std::string_view raw_query, DocumentStatus required_status, const PageRequest& page, const Scoring& scoring) const;
+
+    //    required_status     min_rating;    ,
+    //    ,         ,
+    //      
+    std::vector<Document> FindTopDocumentsWithMinRating(const std::string_view raw_query, int min_rating,
+        DocumentStatus required_status = DocumentStatus::ACTUAL) const;
+
+    //       ,  ;   
+    //         ,  
+    //   
+    std::vector<Document> FindTopRatedDocuments(const std::string_view raw_query,
+        int min_rating = std::numeric_limits<int>::min(), DocumentStatus required_status = DocumentStatus::ACTUAL) const;
 
     MatchDocumentData MatchDocument(const std::string_view raw_query, int document_id) const;
     MatchDocumentData MatchDocument(const std::execution::sequenced_policy&, const std::string_view raw_query, int document_id) const;
     MatchDocumentData MatchDocument(const std::execution::parallel_policy&, const std::string_view raw_query, int document_id) const;
+    MatchDocumentData MatchDocument(const AutoExecutionPolicy&, const std::string_view raw_query, int document_id) const;
+
+    //      ;      id
+    //    ,       
+    template <typename DocumentIds>
+    std::vector<MatchDocumentData> MatchDocuments(const std::string_view raw_query, const DocumentIds& document_ids) const;
+    template <typename Policy, typename DocumentIds>
+    std::vector<MatchDocumentData> MatchDocuments(const Policy& policy, const std::string_view raw_query, const DocumentIds& document_ids) const;
+    template <typename DocumentIds>
+    std::vector<MatchDocumentData> MatchDocuments(const AutoExecutionPolicy&, const std::string_view raw_query, const DocumentIds& document_ids) const;
 
 	//     id  
-    std::set<int>::const_iterator begin() const;
+    std::pmr::set<int>::const_iterator begin() const;
 
     //     id  
-    std::set<int>::const_iterator end() const;
+    std::pmr::set<int>::const_iterator end() const;
 
     //     id 
-    const std::map<std::string_view, double>& GetWordFrequencies(int document_id) const;
+    const WordFrequencies& GetWordFrequencies(int document_id) const;
+
+    // -  (      )   
+    //     ; string_view   raw_query    
+    std::vector<std::pair<std::string_view, size_t>> GetQueryDocumentFrequencies(std::string_view raw_query) const;
 
-    //    id
+    //    id; ,      ,   
     void RemoveDocument(int document_id);
     void RemoveDocument(const std::execution::sequenced_policy&, int document_id);
     void RemoveDocument(const std::execution::parallel_policy&, int document_id);
+    void RemoveDocument(const AutoExecutionPolicy&, int document_id);
+
+    //   ;  id .    , 
+    //      ( execution::par - ), 
+    //  -    ; ,   ,   
+    void RemoveDocuments(const std::vector<int>& document_ids);
+    void RemoveDocuments(const std::execution::sequenced_policy&, const std::vector<int>& document_ids);
+    void RemoveDocuments(const std::execution::parallel_policy&, const std::vector<int>& document_ids);
+    void RemoveDocuments(const AutoExecutionPolicy&, const std::vector<int>& document_ids);
+
+    //    ,       target;  
+    //   target  ,       ;
+    //      
+    void MoveDocument(int document_id, SearchServer& target);
+
+    //  :   ,  ,    id
+    static bool RanksHigher(const Document& lhs, const Document& rhs);
+
+    //   FindTopRatedDocuments:   ,  ,    id
+    static bool RatedHigher(const Document& lhs, const Document& rhs);
 
 private:
 
+    //  :   -        
+    struct Phrase {
+        std::vector<std::string_view> words;
+        uint32_t slop = 0;
+    };
+
     struct Query {
         std::vector<std::string_view> plus_words;
         std::vector<std::string_view> minus_words;
+        //      plus_words
+        std::vector<Phrase> phrases;
+        std::vector<Phrase> minus_phrases;
+        //  ,   ,    ;    plus_words
+        std::vector<std::pair<std::string_view, double>> fuzzy_words;
+    };
+
+    //       IDF
+    struct WordPostings {
+        double idf = 0.;
+        const Postings* postings = nullptr;
+    };
+
+    //   :    
+    struct PostingCursor {
+        Postings::const_iterator current;
+        Postings::const_iterator end;
+        //     
+        size_t word_index = 0;
+    };
+
+    //    ; ,     
+    struct QueryScratch {
+        Query query;
+        std::vector<WordPostings> plus_words_postings;
+        std::vector<const Postings*> minus_words_postings;
+        std::vector<PostingCursor> cursors;
+        std::vector<Postings::const_iterator> minus_cursors;
+        //  ;    -   
+        std::vector<Document> heap;
+        //    
+        bool in_use = false;
+    };
+
+    //      
+    class QueryScratchLock {
+    public:
+        explicit QueryScratchLock(QueryScratch& scratch)
+            : scratch_(scratch) {
+            scratch_.in_use = true;
+        }
+
+        QueryScratchLock(const QueryScratchLock&) = delete;
+        QueryScratchLock& operator=(const QueryScratchLock&) = delete;
+
+        ~QueryScratchLock() {
+            scratch_.in_use = false;
+        }
+
+    private:
+        QueryScratch& scratch_;
     };
 
     struct DocumentData
     {
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        explicit DocumentData(const allocator_type& alloc)
+            : words_positions(alloc) {
+        }
+
         DocumentStatus status = DocumentStatus::ACTUAL;
         int rating = 0;
-        std::set<std::string, std::less<>> words_data;
+        //    -
+        size_t words_count = 0;
+        //   ,       
+        std::pmr::map<std::string_view, PositionList> words_positions;
     };
 
+    //    :        ,
+    //       ,   
+    //     ;   ,   
+    std::unique_ptr<std::pmr::synchronized_pool_resource> memory_resource_ = std::make_unique<std::pmr::synchronized_pool_resource>();
+
     // id  ;
-    std::set<int> added_documents_id_;
+    std::pmr::set<int> added_documents_id_{ memory_resource_.get() };
 
     //std::set<std::string, std::less<>> words_data_;
 
-    // word -> [ document_id, TF ]
-    std::map<std::string_view, std::map<int, double>> word_to_documents_freqs_;
+    // word -> [ document_id, TF ];    ,     
+    TermDictionary<Postings> word_to_documents_freqs_{ memory_resource_.get() };
 
     // id -> [ word, TF ]
-    std::map<int, std::map<std::string_view, double>> document_to_words_freqs_;
+    std::pmr::map<int, WordFrequencies> document_to_words_freqs_{ memory_resource_.get() };
 
     //  id -> { status, rating }
-    std::map<int, DocumentData> documents_data_;
+    std::pmr::map<int, DocumentData> documents_data_{ memory_resource_.get() };
+
+    // rating -> id   
+    RatingIndex rating_index_{ memory_resource_.get() };
+
+    //   
+    DocumentStore document_store_{ memory_resource_.get() };
+    DocumentStoreConfig document_store_config_;
 
     //  -  
-    std::set<std::string, std::less<>> stop_words_;
+    StopWordsSet stop_words_;
+
+    CorpusStats corpus_stats_;
+
+    const CorpusStatsSource* corpus_stats_source_ = nullptr;
+
+    ExecutionThresholds execution_thresholds_;
+
+    bool positional_index_enabled_ = false;
+
+    FuzzyMatching fuzzy_matching_;
+
+    //   ,  -;      
+    MemoryStats memory_stats_;
+
+    size_t memory_budget_ = 0;
 
 private:
 
     bool IsStopWord(const std::string_view word) const;
 
-    //     ,        -
-    std::vector<std::string_view> SplitIntoWordsNoStop(const std::string_view text) const;
+    //   -  SplitIntoWordsNoStop
+    struct NotStopWord {
+        const SearchServer* server = nullptr;
 
-    template <typename Requirement>
-    std::vector<Document> FindAllDocuments(const Query& parsed_query, Requirement requirement) const;
-    template <typename Requirement>
-    std::vector<Document> FindAllDocuments(const std::execution::sequenced_policy&, const Query& parsed_query, Requirement requirement) const;
-    template <typename Requirement>
-    std::vector<Document> FindAllDocuments(const std::execution::parallel_policy&, const Query& parsed_query, Requirement requirement, size_t buckets_count = 100) const;
+        bool operator()(const std::string_view word) const {
+            return !server->IsStopWord(word);
+        }
+    };
+
+    using WordsNoStopRange = FilteredRange<WordIterator, NotStopWord>;
+
+    //     ,  -;   
+    WordsNoStopRange SplitIntoWordsNoStop(const std::string_view text) const;
+
+    //  callback(i, term_freq)   i  [first, last),    sorted_ids[i]   postings
+    template <typename Callback>
+    static void ForEachPostedDocument(const Postings& postings, const std::vector<int>& sorted_ids,
+        size_t first, size_t last, Callback callback);
+
+    //   sorted_ids   required_status,   ,   ;
+    //      sorted_ids,       
+    std::vector<Document> ScoreDocumentsAmong(const Query& parsed_query, const std::vector<int>& sorted_ids,
+        DocumentStatus required_status) const;
+
+    //   - ,   ,   IDF
+    template <typename Scoring>
+    std::vector<WordPostings> LookupPostings(const Query& parsed_query, const Scoring& scoring) const;
+    template <typename Scoring>
+    void LookupPostings(const Query& parsed_query, const Scoring& scoring, std::vector<WordPostings>& plus_words_postings) const;
+
+    //   - ,   
+    std::vector<const Postings*> LookupMinusPostings(const Query& parsed_query) const;
+    void LookupMinusPostings(const Query& parsed_query, std::vector<const Postings*>& minus_words_postings) const;
+
+    //     
+    static QueryScratch& GetThreadQueryScratch();
+
+    //          id: 
+    //       ,   
+    //   ;      scratch
+    template <typename Requirement, typename Scoring>
+    void CollectTopDocuments(const std::string_view raw_query, Requirement requirement, const Scoring& scoring,
+        QueryScratch& scratch, std::vector<Document>& result) const;
+
+    // ,    :     
+    const CorpusStats& GetScoringStats() const;
+
+    //       
+    ExecutionMode PlanExecution(const ExecutionCost& cost) const;
+    //   -     
+    template <typename Scoring>
+    ExecutionCost EstimateExecutionCost(const Query& parsed_query, const Scoring& scoring) const;
+
+    //  ,   : id -> relevance
+    template <typename Requirement, typename Scoring>
+    std::map<int, double> ComputeDocumentsRelevance(const Query& parsed_query, Requirement requirement, const Scoring& scoring) const;
+    template <typename Requirement, typename Scoring>
+    std::map<int, double> ComputeDocumentsRelevance(const std::execution::sequenced_policy&, const Query& parsed_query, Requirement requirement, const Scoring& scoring) const;
+    template <typename Requirement, typename Scoring>
+    std::map<int, double> ComputeDocumentsRelevance(const std::execution::parallel_policy&, const Query& parsed_query, Requirement requirement, const Scoring& scoring, size_t buckets_count = 100) const;
+    template <typename Requirement, typename Scoring>
+    std::map<int, double> ComputeDocumentsRelevance(const AutoExecutionPolicy&, const Query& parsed_query, Requirement requirement, const Scoring& scoring) const;
+    //    id :         
+    template <typename Requirement, typename Scoring>
+    std::map<int, double> ComputeDocumentsRelevancePartitioned(const Query& parsed_query, Requirement requirement, const Scoring& scoring) const;
+
+    template <typename Policy, typename Requirement, typename Scoring>
+    std::vector<Document> FindAllDocuments(const Policy& policy, const Query& parsed_query, Requirement requirement, const Scoring& scoring) const;
+
+    //       
+    DocumentsPage SelectPage(const std::map<int, double>& document_to_relevance, const PageRequest& page) const;
 
     // A valid text must not contain special characters
     bool IsValidText(const std::string_view text) const;
@@ -121,108 +461,209 @@ private:
 
     void ParseQueryWord(const std::string_view word, Query& query) const;
 
+    //   - :   '*'      
+    static bool IsPrefixWord(const std::string_view word);
+
+    //   words     word  '*'
+    void ExpandPrefixWord(const std::string_view word, std::vector<std::string_view>& words) const;
+
+    //   fuzzy_words  ,       word
+    void ExpandFuzzyWord(const std::string_view word, Query& query) const;
+
+    //  ,   word_it;   word_it     
+    void ParsePhrase(WordIterator& word_it, const WordIterator words_end, Query& query) const;
+
+    //   :   '"'  '-"'
+    static bool StartsPhrase(const std::string_view word);
+
+    //             slop
+    static bool MatchesPhrase(const DocumentData& document_data, const Phrase& phrase);
+
+    //         -
+    bool MatchesPhrases(const Query& parsed_query, int document_id) const;
+
+    //  ,        -
+    void FilterByPhrases(const Query& parsed_query, std::map<int, double>& document_to_relevance) const;
+
     // -   {-, -}
     Query ParseQuery(const std::string_view text, const bool erase_duplicates = true) const;
+    //    query,    
+    void ParseQuery(const std::string_view text, Query& query, const bool erase_duplicates = true) const;
 
     static int ComputeAverageRating(const std::vector<int>& ratings);
 
+    //  ,    ,     
+    void EraseDocumentData(int document_id);
+
+    //   ; parallel -     
+    void RemoveDocumentsBatch(const std::vector<int>& document_ids, bool parallel);
+
+    //     words (    ):  ,
+    //   , ,  - ,  -   , 
+    //  ;  ,     .
+    //  ,   :     
+    std::vector<std::string_view> UpdateDocumentWords(int document_id, const std::vector<std::string_view>& words, bool record_positions);
+
+    void SetDocumentMetadata(int document_id, DocumentStatus status, int rating);
+
+    //     ;      -  
+    //   ,    
+    std::vector<std::string_view> GetDocumentWords(int document_id) const;
+
+    //     ,    word_to_documents_freqs_,
+    //      
+    MemoryStats ComputeDocumentMemory(int document_id) const;
+    //        :       
+    size_t EstimateStoredTextSize(std::string_view document) const;
+
     int GetDocumentRating(int document_id) const;
 };
 
 template<typename StringCollection>
-SearchServer::SearchServer(const StringCollection& stop_words)
-    : stop_words_(MakeUniqueNonEmptyStrings(stop_words)) {
+SearchServer::SearchServer(const StringCollection& stop_words) {
 
     using namespace std;
 
-    for (const string& word : stop_words_) {
+    auto unique_stop_words = MakeUniqueNonEmptyStrings(stop_words);
+    for (const string& word : unique_stop_words) {
         if (!IsValidText(word))
         {
             throw invalid_argument("Stop word contains special characters"s);
         }
     }
+
+    stop_words_ = StopWordsSet(move(unique_stop_words));
 }
 
-template <typename Requirement>
-std::vector<Document> SearchServer::FindAllDocuments(const Query& parsed_query, Requirement requirement) const {
+template<size_t N>
+SearchServer::SearchServer(const StaticStopWords<N>& stop_words)
+    : stop_words_(stop_words) {
 
     using namespace std;
 
-    vector<Document> matched_documents;
+    for (const string_view word : stop_words) {
+        if (!IsValidText(word))
+        {
+            throw invalid_argument("Stop word contains special characters"s);
+        }
+    }
+}
+
+template <typename Scoring>
+std::vector<SearchServer::WordPostings> SearchServer::LookupPostings(const Query& parsed_query, const Scoring& scoring) const {
+
+    std::vector<WordPostings> plus_words_postings;
+    plus_words_postings.reserve(parsed_query.plus_words.size());
+    LookupPostings(parsed_query, scoring, plus_words_postings);
+    return plus_words_postings;
+}
+
+template <typename Scoring>
+void SearchServer::LookupPostings(const Query& parsed_query, const Scoring& scoring, std::vector<WordPostings>& plus_words_postings) const {
+
+    using namespace std;
+
+    TRACE_SPAN("LookupPostings");
+
+    plus_words_postings.clear();
+    //         IDF
+    const auto add_postings = [&](const string_view word, double weight) {
+        const Postings* postings = word_to_documents_freqs_.Find(word);
+        if (postings != nullptr && !postings->empty())
+        {
+            const size_t document_freq = corpus_stats_source_ ? corpus_stats_source_->GetDocumentFrequency(word) : postings->size();
+            plus_words_postings.push_back({ scoring.ComputeIdf(GetScoringStats(), document_freq) * weight, postings });
+        }
+    };
+    for (const string_view plus_word : parsed_query.plus_words) {
+        add_postings(plus_word, 1.);
+    }
+    for (const auto& [fuzzy_word, weight] : parsed_query.fuzzy_words) {
+        add_postings(fuzzy_word, weight);
+    }
+}
+
+template <typename Requirement, typename Scoring>
+std::map<int, double> SearchServer::ComputeDocumentsRelevance(const Query& parsed_query, Requirement requirement, const Scoring& scoring) const {
+
+    using namespace std;
 
     // [id, relevance]
     map<int, double> document_term_freq_idf_relevance;
 
-    for (const string_view plus_word : parsed_query.plus_words) {
-        if (word_to_documents_freqs_.count(plus_word))
-        {
-            double word_idf = log(static_cast<double>(added_documents_id_.size()) / word_to_documents_freqs_.at(plus_word).size());
-            for (const auto& [document_id, term_freq] : word_to_documents_freqs_.at(plus_word)) {
+    const auto plus_words_postings = LookupPostings(parsed_query, scoring);
+    const auto score = scoring.MakeKernel(GetScoringStats());
+
+    {
+        TRACE_SPAN("ScoreDocuments");
+        for (const auto& [word_idf, postings] : plus_words_postings) {
+            for (const auto& [document_id, term_freq] : *postings) {
                 const auto& current_document_data = documents_data_.at(document_id);
                 if (requirement(document_id, current_document_data.status, current_document_data.rating))
                 {
-                    document_term_freq_idf_relevance[document_id] += word_idf * term_freq;
+                    document_term_freq_idf_relevance[document_id] += score(word_idf, term_freq, current_document_data.words_count);
                 }
             }
         }
     }
+
+    TRACE_SPAN("ExcludeMinusWords");
     for (const string_view minus_word : parsed_query.minus_words) {
-        if (word_to_documents_freqs_.count(minus_word))
+        if (const Postings* postings = word_to_documents_freqs_.Find(minus_word))
         {
-            for (const auto& [document_id, term_freq] : word_to_documents_freqs_.at(minus_word)) {
+            for (const auto& [document_id, term_freq] : *postings) {
                 document_term_freq_idf_relevance.erase(document_id);
             }
         }
     }
 
-    for (const auto& [document_id, relevance] : document_term_freq_idf_relevance) {
-        matched_documents.push_back({ document_id, relevance, GetDocumentRating(document_id) });
-    }
+    FilterByPhrases(parsed_query, document_term_freq_idf_relevance);
 
-    return matched_documents;
+    return document_term_freq_idf_relevance;
 }
 
-template <typename Requirement>
-std::vector<Document> SearchServer::FindAllDocuments
-(const std::execution::sequenced_policy&, const Query& parsed_query, Requirement requirement) const {
+template <typename Requirement, typename Scoring>
+std::map<int, double> SearchServer::ComputeDocumentsRelevance
+(const std::execution::sequenced_policy&, const Query& parsed_query, Requirement requirement, const Scoring& scoring) const {
 
-    return SearchServer::FindAllDocuments(parsed_query, requirement);
+    return SearchServer::ComputeDocumentsRelevance(parsed_query, requirement, scoring);
 }
 
-template <typename Requirement>
-std::vector<Document> SearchServer::FindAllDocuments
-(const std::execution::parallel_policy&, const Query& parsed_query, Requirement requirement, size_t buckets_count) const {
+template <typename Requirement, typename Scoring>
+std::map<int, double> SearchServer::ComputeDocumentsRelevance
+(const std::execution::parallel_policy&, const Query& parsed_query, Requirement requirement, const Scoring& scoring, size_t buckets_count) const {
 
     using namespace std;
 
-    vector<Document> matched_documents;
-
     ConcurrentMap<int, double> docs_to_relevance(buckets_count);
 
     set<int> docs_to_ignore;
     std::mutex mutex;
 
-	for_each(execution::par, parsed_query.plus_words.begin(), parsed_query.plus_words.end(),
-		[&](const string_view plus_word) {
-			if (word_to_documents_freqs_.count(plus_word))
-			{
-				double word_idf = log(static_cast<double>(added_documents_id_.size()) / word_to_documents_freqs_.at(plus_word).size());
-				for (const auto& [document_id, term_freq] : word_to_documents_freqs_.at(plus_word)) {
-					const auto& current_document_data = documents_data_.at(document_id);
-					if (requirement(document_id, current_document_data.status, current_document_data.rating))
-					{
-						docs_to_relevance[document_id].ref_to_value += word_idf * term_freq;
-					}
-				}
-			}
-		}
-	);
+    const auto plus_words_postings = LookupPostings(parsed_query, scoring);
+    const auto score = scoring.MakeKernel(GetScoringStats());
+
+    {
+        TRACE_SPAN("ScoreDocuments");
+        for_each(execution::par, plus_words_postings.begin(), plus_words_postings.end(),
+            [&](const WordPostings& word_postings) {
+                for (const auto& [document_id, term_freq] : *word_postings.postings) {
+                    const auto& current_document_data = documents_data_.at(document_id);
+                    if (requirement(document_id, current_document_data.status, current_document_data.rating))
+                    {
+                        docs_to_relevance[document_id].ref_to_value += score(word_postings.idf, term_freq, current_document_data.words_count);
+                    }
+                }
+            }
+        );
+    }
 
+    TRACE_SPAN("ExcludeMinusWords");
 	for_each(execution::par, parsed_query.minus_words.begin(), parsed_query.minus_words.end(),
 		[&](const string_view minus_word) {
-			if (word_to_documents_freqs_.count(minus_word))
+			if (const Postings* postings = word_to_documents_freqs_.Find(minus_word))
 			{
-				for (const auto& [document_id, term_freq] : word_to_documents_freqs_.at(minus_word)) {
+				for (const auto& [document_id, term_freq] : *postings) {
 
                     lock_guard guard(mutex);
                     docs_to_ignore.insert(document_id);
@@ -231,54 +672,179 @@ std::vector<Document> SearchServer::FindAllDocuments
 		}
 	);
 
-    for (const auto& [document_id, relevance] : docs_to_relevance.BuildOrdinaryMap()) {
-        if (!docs_to_ignore.count(document_id)) {
-            matched_documents.push_back({ document_id, relevance, GetDocumentRating(document_id) });
-        }
+    map<int, double> document_to_relevance = docs_to_relevance.BuildOrdinaryMap();
+    for (const int document_id : docs_to_ignore) {
+        document_to_relevance.erase(document_id);
     }
 
-    return matched_documents;
+    FilterByPhrases(parsed_query, document_to_relevance);
+
+    return document_to_relevance;
 }
 
-template <typename Requirement>
-std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query, Requirement requirement) const {
+template <typename Scoring>
+ExecutionCost SearchServer::EstimateExecutionCost(const Query& parsed_query, const Scoring& scoring) const {
+    ExecutionCost cost;
+    for (const auto& word_postings : LookupPostings(parsed_query, scoring)) {
+        cost.work += word_postings.postings->size();
+    }
+    for (const auto* postings : LookupMinusPostings(parsed_query)) {
+        cost.work += postings->size();
+    }
+    cost.parallel_units = parsed_query.plus_words.size() + parsed_query.fuzzy_words.size();
+    return cost;
+}
 
-	using namespace std;
+template <typename Requirement, typename Scoring>
+std::map<int, double> SearchServer::ComputeDocumentsRelevance
+(const AutoExecutionPolicy&, const Query& parsed_query, Requirement requirement, const Scoring& scoring) const {
 
-	// throws invalid_argument exception
-	Query parsed_query = ParseQuery(raw_query);
+    using namespace std;
 
-	auto matched_documents = FindAllDocuments(parsed_query, requirement);
+    switch (PlanExecution(EstimateExecutionCost(parsed_query, scoring))) {
+    case ExecutionMode::SEQUENTIAL:
+        return ComputeDocumentsRelevance(execution::seq, parsed_query, requirement, scoring);
+    case ExecutionMode::INTRA_QUERY_PARALLEL:
+        return ComputeDocumentsRelevance(execution::par, parsed_query, requirement, scoring);
+    case ExecutionMode::PARTITIONED:
+        break;
+    }
+    return ComputeDocumentsRelevancePartitioned(parsed_query, requirement, scoring);
+}
+
+template <typename Requirement, typename Scoring>
+std::map<int, double> SearchServer::ComputeDocumentsRelevancePartitioned(const Query& parsed_query, Requirement requirement, const Scoring& scoring) const {
 
-	sort(matched_documents.begin(), matched_documents.end(),
-		[](const Document& lhs, const Document& rhs) {
-			return lhs.relevance > rhs.relevance ||
-				(abs(lhs.relevance - rhs.relevance) < EPSILON && lhs.rating > rhs.rating);
-		});
+    using namespace std;
+
+    if (added_documents_id_.empty())
+    {
+        return {};
+    }
 
-	if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
-		matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
-	}
+    const auto plus_words_postings = LookupPostings(parsed_query, scoring);
+    const auto minus_words_postings = LookupMinusPostings(parsed_query);
+    const auto score = scoring.MakeKernel(GetScoringStats());
+
+    //  ,  ,      id
+    const size_t partitions_count = max(1u, thread::hardware_concurrency()) * 4;
+    //    int64_t:        INT_MAX
+    const int64_t first_id = *added_documents_id_.begin();
+    const int64_t last_id = *added_documents_id_.rbegin();
+    const int64_t partition_size = (last_id - first_id) / static_cast<int64_t>(partitions_count) + 1;
+
+    vector<map<int, double>> partitions_relevance(partitions_count);
+    vector<size_t> partitions(partitions_count);
+    iota(partitions.begin(), partitions.end(), 0);
+
+    TRACE_SPAN("ScoreDocumentsPartitioned");
+    for_each(execution::par, partitions.begin(), partitions.end(),
+        [&](size_t partition) {
+            const int64_t lower_id = first_id + partition_size * static_cast<int64_t>(partition);
+            const int64_t upper_id = lower_id + partition_size;
+            if (lower_id > last_id)
+            {
+                return;
+            }
+            //  lower_id   last_id    int
+            auto& document_to_relevance = partitions_relevance[partition];
+
+            for (const auto& [word_idf, postings] : plus_words_postings) {
+                for (auto posting = postings->lower_bound(static_cast<int>(lower_id));
+                    posting != postings->end() && posting->first < upper_id; ++posting) {
+                    const auto& current_document_data = documents_data_.at(posting->first);
+                    if (requirement(posting->first, current_document_data.status, current_document_data.rating))
+                    {
+                        document_to_relevance[posting->first] += score(word_idf, posting->second, current_document_data.words_count);
+                    }
+                }
+            }
 
-	return matched_documents;
+            for (const auto* postings : minus_words_postings) {
+                for (auto posting = postings->lower_bound(static_cast<int>(lower_id));
+                    posting != postings->end() && posting->first < upper_id; ++posting) {
+                    document_to_relevance.erase(posting->first);
+                }
+            }
+
+            FilterByPhrases(parsed_query, document_to_relevance);
+        }
+    );
+
+    //        id,     
+    map<int, double> document_to_relevance;
+    for (const auto& partition_relevance : partitions_relevance) {
+        for (const auto& document_relevance : partition_relevance) {
+            document_to_relevance.insert(document_to_relevance.end(), document_relevance);
+        }
+    }
+
+    return document_to_relevance;
+}
+
+template <typename Policy, typename Requirement, typename Scoring>
+std::vector<Document> SearchServer::FindAllDocuments
+(const Policy& policy, const Query& parsed_query, Requirement requirement, const Scoring& scoring) const {
+
+    using namespace std;
+
+    vector<Document> matched_documents;
+    for (const auto& [document_id, relevance] : ComputeDocumentsRelevance(policy, parsed_query, requirement, scoring)) {
+        matched_documents.push_back({ document_id, relevance, GetDocumentRating(document_id) });
+    }
+
+    return matched_documents;
+}
+
+template <typename Requirement>
+std::vector<Document> SearchServer::FindTopDocuments(const std::string_view raw_query, Requirement requirement) const {
+
+	return FindTopDocuments(std::execution::seq, raw_query, requirement);
 }
 
 template <typename Policy, typename Requirement>
 std::vector<Document> SearchServer::FindTopDocuments
 (const Policy& policy, const std::string_view raw_query, Requirement requirement) const {
 
+    return FindTopDocuments(policy, raw_query, requirement, TfIdfScoring());
+}
+
+template <typename Policy, typename Requirement, typename Scoring>
+std::vector<Document> SearchServer::FindTopDocuments
+(const Policy& policy, const std::string_view raw_query, Requirement requirement, const Scoring& scoring) const {
+
     using namespace std;
 
+    if constexpr (is_same_v<Policy, execution::sequenced_policy>)
+    {
+        vector<Document> result;
+        FindTopDocuments(raw_query, requirement, result, scoring);
+        return result;
+    }
+    if constexpr (is_same_v<Policy, AutoExecutionPolicy>)
+    {
+        //       ,   execution::seq
+        bool is_sequential = false;
+        {
+            const ActiveQueryScope active_query;
+            is_sequential = PlanExecution(EstimateExecutionCost(ParseQuery(raw_query), scoring)) == ExecutionMode::SEQUENTIAL;
+        }
+        if (is_sequential)
+        {
+            return FindTopDocuments(execution::seq, raw_query, requirement, scoring);
+        }
+    }
+
+    TRACE_SPAN("FindTopDocuments");
+    const ActiveQueryScope active_query;
+
     // throws invalid_argument exception
     Query parsed_query = ParseQuery(raw_query);
 
-    auto matched_documents = FindAllDocuments(policy, parsed_query, requirement);
+    auto matched_documents = FindAllDocuments(policy, parsed_query, requirement, scoring);
 
-    sort(matched_documents.begin(), matched_documents.end(),
-        [](const Document& lhs, const Document& rhs) {
-            return lhs.relevance > rhs.relevance ||
-                (abs(lhs.relevance - rhs.relevance) < EPSILON && lhs.rating > rhs.rating);
-        });
+    TRACE_SPAN("SortTopDocuments");
+    sort(matched_documents.begin(), matched_documents.end(), RanksHigher);
 
     if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
         matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
@@ -301,7 +867,336 @@ std::vector<Document> SearchServer::FindTopDocuments(const Policy& policy, const
     return FindTopDocuments(policy, raw_query, DocumentStatus::ACTUAL);
 }
 
-void PrintMatchDocumentResult(int document_id, const std::vector<std::string>& words, DocumentStatus status);
+template <typename Policy, typename Scoring>
+std::vector<Document> SearchServer::FindTopDocuments
+(const Policy& policy, const std::string_view raw_query, DocumentStatus required_status, const Scoring& scoring) const
+{
+    return FindTopDocuments(policy, raw_query,
+        [required_status](int, DocumentStatus doc_status, int)
+        {return doc_status == required_status; }, scoring);
+}
+
+template <typename Requirement, typename Scoring>
+void SearchServer::FindTopDocuments
+(const std::string_view raw_query, Requirement requirement, std::vector<Document>& result, const Scoring& scoring) const {
+
+    TRACE_SPAN("FindTopDocuments");
+    const ActiveQueryScope active_query;
+
+    // ,   requirement,    ,     
+    QueryScratch& thread_scratch = GetThreadQueryScratch();
+    QueryScratch nested_scratch;
+    QueryScratch& scratch = thread_scratch.in_use ? nested_scratch : thread_scratch;
+    const QueryScratchLock scratch_lock(scratch);
+
+    CollectTopDocuments(raw_query, requirement, scoring, scratch, result);
+}
+
+template <typename Requirement, typename Scoring>
+void SearchServer::CollectTopDocuments(const std::string_view raw_query, Requirement requirement, const Scoring& scoring,
+    QueryScratch& scratch, std::vector<Document>& result) const {
+
+    using namespace std;
+
+    // throws invalid_argument exception
+    ParseQuery(raw_query, scratch.query);
+
+    const auto& plus_words_postings = scratch.plus_words_postings;
+    const auto& minus_words_postings = scratch.minus_words_postings;
+    LookupPostings(scratch.query, scoring, scratch.plus_words_postings);
+    LookupMinusPostings(scratch.query, scratch.minus_words_postings);
+    const auto score = scoring.MakeKernel(GetScoringStats());
+
+    //  :    id,   id - ,    ,
+    //       ,       
+    auto& cursors = scratch.cursors;
+    cursors.clear();
+    for (size_t i = 0; i < plus_words_postings.size(); ++i) {
+        cursors.push_back({ plus_words_postings[i].postings->begin(), plus_words_postings[i].postings->end(), i });
+    }
+    const auto cursor_after = [](const PostingCursor& lhs, const PostingCursor& rhs) {
+        if (lhs.current->first != rhs.current->first)
+        {
+            return lhs.current->first > rhs.current->first;
+        }
+        return lhs.word_index > rhs.word_index;
+    };
+    make_heap(cursors.begin(), cursors.end(), cursor_after);
+
+    auto& minus_cursors = scratch.minus_cursors;
+    minus_cursors.clear();
+    for (const auto* postings : minus_words_postings) {
+        minus_cursors.push_back(postings->begin());
+    }
+
+    auto& heap = scratch.heap;
+    heap.clear();
+
+    TRACE_SPAN("ScoreDocumentsMerged");
+    while (!cursors.empty()) {
+        const int document_id = cursors.front().current->first;
+        //           
+        const DocumentData& document_data = documents_data_.at(document_id);
+        const bool is_required = requirement(document_id, document_data.status, document_data.rating);
+
+        double relevance = 0.;
+        while (!cursors.empty() && cursors.front().current->first == document_id) {
+            pop_heap(cursors.begin(), cursors.end(), cursor_after);
+            PostingCursor& cursor = cursors.back();
+            if (is_required)
+            {
+                relevance += score(plus_words_postings[cursor.word_index].idf, cursor.current->second, document_data.words_count);
+            }
+            if (++cursor.current == cursor.end)
+            {
+                cursors.pop_back();
+            }
+            else
+            {
+                push_heap(cursors.begin(), cursors.end(), cursor_after);
+            }
+        }
+
+        // -     id,      
+        bool has_minus_word = false;
+        for (size_t i = 0; i < minus_cursors.size(); ++i) {
+            auto& minus_cursor = minus_cursors[i];
+            const auto minus_end = minus_words_postings[i]->end();
+            while (minus_cursor != minus_end && minus_cursor->first < document_id) {
+                ++minus_cursor;
+            }
+            has_minus_word = has_minus_word || (minus_cursor != minus_end && minus_cursor->first == document_id);
+        }
+
+        if (!is_required || has_minus_word || !MatchesPhrases(scratch.query, document_id))
+        {
+            continue;
+        }
+
+        const Document document(document_id, relevance, document_data.rating);
+        if (heap.size() < static_cast<size_t>(MAX_RESULT_DOCUMENT_COUNT))
+        {
+            heap.push_back(document);
+            push_heap(heap.begin(), heap.end(), RanksHigher);
+        }
+        else if (RanksHigher(document, heap.front()))
+        {
+            pop_heap(heap.begin(), heap.end(), RanksHigher);
+            heap.back() = document;
+            push_heap(heap.begin(), heap.end(), RanksHigher);
+        }
+    }
+
+    sort_heap(heap.begin(), heap.end(), RanksHigher);
+    result.assign(heap.begin(), heap.end());
+}
+
+template <typename Requirement>
+DocumentsPage SearchServer::FindTopDocumentsPage
+(const std::string_view raw_query, Requirement requirement, const PageRequest& page) const {
+
+    return FindTopDocumentsPage(std::execution::seq, raw_query, requirement, page);
+}
+
+template <typename Policy, typename Requirement>
+DocumentsPage SearchServer::FindTopDocumentsPage
+(const Policy& policy, const std::string_view raw_query, Requirement requirement, const PageRequest& page) const {
+
+    return FindTopDocumentsPage(policy, raw_query, requirement, page, TfIdfScoring());
+}
+
+template <typename Policy, typename Requirement, typename Scoring>
+DocumentsPage SearchServer::FindTopDocumentsPage
+(const Policy& policy, const std::string_view raw_query, Requirement requirement, const PageRequest& page, const Scoring& scoring) const {
+
+    using namespace std;
+
+    TRACE_SPAN("FindTopDocumentsPage");
+    const ActiveQueryScope active_query;
+
+    if (page.count == 0)
+    {
+        throw invalid_argument("Page size must be positive"s);
+    }
+
+    // throws invalid_argument exception
+    Query parsed_query = ParseQuery(raw_query);
+
+    return SelectPage(ComputeDocumentsRelevance(policy, parsed_query, requirement, scoring), page);
+}
+
+template <typename Policy>
+DocumentsPage SearchServer::FindTopDocumentsPage
+(const Policy& policy, const std::string_view raw_query, DocumentStatus required_status, const PageRequest& page) const
+{
+    return FindTopDocumentsPage(policy, raw_query,
+        [required_status](int, DocumentStatus doc_status, int)
+        {return doc_status == required_status; }, page);
+}
+
+template <typename Policy>
+DocumentsPage SearchServer::FindTopDocumentsPage(const Policy& policy, const std::string_view raw_query, const PageRequest& page) const
+{
+    return FindTopDocumentsPage(policy, raw_query, DocumentStatus::ACTUAL, page);
+}
+
+template <typename Policy, typename Scoring>
+DocumentsPage SearchServer::FindTopDocumentsPage
+(const Policy& policy, const std::string_view raw_query, DocumentStatus required_status, const PageRequest& page, const Scoring& scoring) const
+{
+    return FindTopDocumentsPage(policy, raw_query,
+        [required_status](int, DocumentStatus doc_status, int)
+        {return doc_status == required_status; }, page, scoring);
+}
+
+template <typename DocumentIds>
+std::vector<MatchDocumentData> SearchServer::MatchDocuments(const std::string_view raw_query, const DocumentIds& document_ids) const {
+
+    return MatchDocuments(std::execution::seq, raw_query, document_ids);
+}
+
+template <typename Policy, typename DocumentIds>
+std::vector<MatchDocumentData> SearchServer::MatchDocuments
+(const Policy& policy, const std::string_view raw_query, const DocumentIds& document_ids) const {
+
+    using namespace std;
+
+    TRACE_SPAN("MatchDocuments");
+    const ActiveQueryScope active_query;
+
+    vector<int> ids;
+    for (const int document_id : document_ids) {
+        //      id
+        if (!documents_data_.count(document_id))
+        {
+            throw out_of_range("No document with given id"s);
+        }
+        ids.push_back(document_id);
+    }
+
+    // throws invalid_argument exception
+    const Query parsed_query = ParseQuery(raw_query);
+
+    vector<int> sorted_ids = ids;
+    sort(sorted_ids.begin(), sorted_ids.end());
+    sorted_ids.erase(unique(sorted_ids.begin(), sorted_ids.end()), sorted_ids.end());
+
+    //   ,   
+    const auto minus_words_postings = LookupMinusPostings(parsed_query);
+    vector<pair<string_view, const Postings*>> plus_words_postings;
+    for (const string_view plus_word : parsed_query.plus_words) {
+        if (const Postings* postings = word_to_documents_freqs_.Find(plus_word))
+        {
+            plus_words_postings.push_back({ plus_word, postings });
+        }
+    }
+    for (const auto& [fuzzy_word, weight] : parsed_query.fuzzy_words) {
+        if (const Postings* postings = word_to_documents_freqs_.Find(fuzzy_word))
+        {
+            plus_words_postings.push_back({ fuzzy_word, postings });
+        }
+    }
+
+    //   sorted_ids:  -    -
+    // (char,   bool:    )
+    vector<vector<string_view>> matched_words(sorted_ids.size());
+    vector<char> has_minus_word(sorted_ids.size(), 0);
+
+    vector<size_t> chunks((sorted_ids.size() + MATCH_DOCUMENTS_CHUNK_SIZE - 1) / MATCH_DOCUMENTS_CHUNK_SIZE);
+    iota(chunks.begin(), chunks.end(), 0);
+
+    for_each(policy, chunks.begin(), chunks.end(),
+        [&](size_t chunk) {
+            const size_t first = chunk * MATCH_DOCUMENTS_CHUNK_SIZE;
+            const size_t last = min(first + MATCH_DOCUMENTS_CHUNK_SIZE, sorted_ids.size());
+
+            for (const auto* postings : minus_words_postings) {
+                ForEachPostedDocument(*postings, sorted_ids, first, last, [&](size_t i, double) {
+                    has_minus_word[i] = 1;
+                    });
+            }
+            for (const auto& [plus_word, postings] : plus_words_postings) {
+                ForEachPostedDocument(*postings, sorted_ids, first, last, [&, plus_word = plus_word](size_t i, double) {
+                    if (!has_minus_word[i])
+                    {
+                        matched_words[i].push_back(plus_word);
+                    }
+                    });
+            }
+
+            if (!parsed_query.phrases.empty() || !parsed_query.minus_phrases.empty())
+            {
+                for (size_t i = first; i < last; ++i) {
+                    if (!matched_words[i].empty() && !MatchesPhrases(parsed_query, sorted_ids[i]))
+                    {
+                        matched_words[i].clear();
+                    }
+                }
+            }
+        }
+    );
+
+    vector<MatchDocumentData> result;
+    result.reserve(ids.size());
+    for (const int document_id : ids) {
+        const size_t i = lower_bound(sorted_ids.begin(), sorted_ids.end(), document_id) - sorted_ids.begin();
+        result.emplace_back(matched_words[i], documents_data_.at(document_id).status);
+    }
+
+    return result;
+}
+
+template <typename DocumentIds>
+std::vector<MatchDocumentData> SearchServer::MatchDocuments
+(const AutoExecutionPolicy&, const std::string_view raw_query, const DocumentIds& document_ids) const {
+
+    using namespace std;
+
+    //  -      ;  -  
+    const WordRange query_words = SplitIntoWords(raw_query);
+    const size_t words_count = distance(query_words.begin(), query_words.end());
+    const size_t documents_count = distance(document_ids.begin(), document_ids.end());
+    const ExecutionCost cost{ words_count * documents_count,
+        (documents_count + MATCH_DOCUMENTS_CHUNK_SIZE - 1) / MATCH_DOCUMENTS_CHUNK_SIZE };
+
+    if (PlanExecution(cost) == ExecutionMode::SEQUENTIAL)
+    {
+        return MatchDocuments(execution::seq, raw_query, document_ids);
+    }
+    return MatchDocuments(execution::par, raw_query, document_ids);
+}
+
+template <typename Callback>
+void SearchServer::ForEachPostedDocument(const Postings& postings, const std::vector<int>& sorted_ids,
+    size_t first, size_t last, Callback callback) {
+
+    //         ,
+    //   -     
+    if ((last - first) * 16 < postings.size())
+    {
+        for (size_t i = first; i < last; ++i) {
+            const auto posting = postings.find(sorted_ids[i]);
+            if (posting != postings.end())
+            {
+                callback(i, posting->second);
+            }
+        }
+        return;
+    }
+
+    auto posting = postings.lower_bound(sorted_ids[first]);
+    for (size_t i = first; i < last && posting != postings.end(); ++i) {
+        while (posting != postings.end() && posting->first < sorted_ids[i]) {
+            ++posting;
+        }
+        if (posting != postings.end() && posting->first == sorted_ids[i])
+        {
+            callback(i, posting->second);
+        }
+    }
+}
+
+void PrintMatchDocumentResult(int document_id, const std::vector<std::string_view>& words, DocumentStatus status);
 
 void AddDocument(SearchServer& search_server, int document_id, const std::string& document,
     DocumentStatus status, const std::vector<int>& ratings);
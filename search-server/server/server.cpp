@@ -0,0 +1,96 @@
+/**
+ *  ,    TCP (   network_server.h).
+ *
+ *         .cpp  search-server,
+ *  main.cpp.   SIGINT  SIGTERM.
+ *
+ *  ( ):
+ *  --address=A         ,     (127.0.0.1)
+ *  --port=N             (8080)
+ *  --threads=N          ; 0 -     (0)
+ *  --stop-words=S      -  
+ *  --positions=0|1           (0)
+ *  --fuzzy=N                N , 0 -   (0)
+ *  --store-texts=0|1        TEXT (0)
+ *  --max-pipeline=N     ,     (64)
+ *  --max-output=N         ,     (1048576)
+ *
+ *     localhost:
+ *  ./server --port=8080 &
+ *  printf 'ADD 1 ACTUAL 1 5 curly cat\nFIND cat\n' | nc -q1 127.0.0.1 8080
+ */
+
+#include "../network_server.h"
+
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+struct ServerConfig {
+    NetworkServerConfig network;
+    string stop_words;
+    bool positions = false;
+    FuzzyMatching fuzzy;
+    DocumentStoreConfig document_store;
+};
+
+static ServerConfig ParseArguments(int argc, char* argv[]) {
+    ServerConfig config;
+    config.network.port = 8080;
+    for (int i = 1; i < argc; ++i) {
+        const string argument = argv[i];
+        const auto eq = argument.find('=');
+        if (argument.rfind("--", 0) != 0 || eq == string::npos)
+        {
+            throw invalid_argument("Unexpected argument "s + argument);
+        }
+        const string key = argument.substr(2, eq - 2);
+        const string value = argument.substr(eq + 1);
+
+        if (key == "address") config.network.address = value;
+        else if (key == "port") config.network.port = static_cast<uint16_t>(stoul(value));
+        else if (key == "threads") config.network.threads = stoul(value);
+        else if (key == "stop-words") config.stop_words = value;
+        else if (key == "positions") config.positions = stoi(value) != 0;
+        else if (key == "fuzzy") config.fuzzy.max_edits = static_cast<uint32_t>(stoul(value));
+        else if (key == "store-texts") config.document_store.enabled = stoi(value) != 0;
+        else if (key == "max-pipeline") config.network.max_pipeline_size = stoul(value);
+        else if (key == "max-output") config.network.max_output_size = stoul(value);
+        else throw invalid_argument("Unknown option --"s + key);
+    }
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        const ServerConfig config = ParseArguments(argc, argv);
+
+        SearchServer search_server(config.stop_words);
+        search_server.SetPositionalIndex(config.positions);
+        search_server.SetFuzzyMatching(config.fuzzy);
+        search_server.SetDocumentStore(config.document_store);
+
+        //      ,     sigwait
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        NetworkServer network_server(search_server, config.network);
+        network_server.Start();
+        cerr << "Listening on "s << config.network.address << ':' << network_server.GetPort() << endl;
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+        network_server.Stop();
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+/**
+ *  : SearchServer,    (shard_worker.h)  Unix-.
+ *
+ *         .cpp  search-server,
+ *  main.cpp.  StartLocalShards  .   SIGTERM.
+ *
+ * :
+ *  --socket=PATH       Unix-,    
+ *  --listen-fd=N         ,    ( --socket)
+ *  --stop-words=S      -  
+ *  --positions=0|1           (0)
+ *
+ *  ./shard --socket=/tmp/shard0.sock --stop-words="and in on" &
+ */
+
+#include "../shard_worker.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+struct ShardConfig {
+    string socket_path;
+    int listen_fd = -1;
+    string stop_words;
+    bool positions = false;
+};
+
+static ShardConfig ParseArguments(int argc, char* argv[]) {
+    ShardConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const string argument = argv[i];
+        const auto eq = argument.find('=');
+        if (argument.rfind("--", 0) != 0 || eq == string::npos)
+        {
+            throw invalid_argument("Unexpected argument "s + argument);
+        }
+        const string key = argument.substr(2, eq - 2);
+        const string value = argument.substr(eq + 1);
+
+        if (key == "socket") config.socket_path = value;
+        else if (key == "listen-fd") config.listen_fd = stoi(value);
+        else if (key == "stop-words") config.stop_words = value;
+        else if (key == "positions") config.positions = stoi(value) != 0;
+        else throw invalid_argument("Unknown option --"s + key);
+    }
+    if (config.socket_path.empty() == (config.listen_fd < 0))
+    {
+        throw invalid_argument("Exactly one of --socket and --listen-fd is required"s);
+    }
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        const ShardConfig config = ParseArguments(argc, argv);
+
+        SearchServer search_server(config.stop_words);
+        search_server.SetPositionalIndex(config.positions);
+
+        if (config.listen_fd >= 0)
+        {
+            ServeShard(config.listen_fd, search_server);
+        }
+        else
+        {
+            RunShardWorker(config.socket_path, search_server);
+        }
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,404 @@
+#include "shard_coordinator.h"
+
+#ifdef __linux__
+
+#include "sharded_search_server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+static int ConnectShardSocket(const string& socket_path, chrono::steady_clock::time_point deadline) {
+
+    sockaddr_un address = {};
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        throw invalid_argument("Shard socket path is too long"s);
+    }
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, socket_path.data(), socket_path.size());
+
+    while (true) {
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            throw system_error(errno, generic_category(), "socket"s);
+        }
+        if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+        {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            return fd;
+        }
+
+        const int error = errno;
+        close(fd);
+        //      
+        if ((error != ENOENT && error != ECONNREFUSED && error != EINTR) || chrono::steady_clock::now() >= deadline)
+        {
+            throw system_error(error, generic_category(), "Cannot connect to "s + socket_path);
+        }
+        this_thread::sleep_for(10ms);
+    }
+}
+
+[[noreturn]] static void ThrowShardError(const ShardFrame& reply) {
+    MessageReader reader(reply.payload);
+    const ShardErrorKind error_kind = static_cast<ShardErrorKind>(reader.GetUint());
+    const string message(reader.GetString());
+
+    switch (error_kind) {
+    case ShardErrorKind::INVALID_ARGUMENT:
+        throw invalid_argument(message);
+    case ShardErrorKind::OUT_OF_RANGE:
+        throw out_of_range(message);
+    default:
+        throw runtime_error(message);
+    }
+}
+
+ShardCoordinator::ShardCoordinator(const vector<string>& socket_paths, chrono::milliseconds timeout)
+    : timeout_(timeout) {
+
+    if (socket_paths.empty())
+    {
+        throw invalid_argument("Shards count must be positive"s);
+    }
+
+    const auto deadline = chrono::steady_clock::now() + timeout_;
+    shards_.resize(socket_paths.size());
+    try {
+        for (size_t i = 0; i < socket_paths.size(); ++i) {
+            shards_[i].fd = ConnectShardSocket(socket_paths[i], deadline);
+        }
+    }
+    catch (...) {
+        for (ShardConnection& connection : shards_) {
+            CloseConnection(connection);
+        }
+        throw;
+    }
+}
+
+ShardCoordinator::~ShardCoordinator() {
+    for (ShardConnection& connection : shards_) {
+        CloseConnection(connection);
+    }
+}
+
+size_t ShardCoordinator::GetShardsCount() const {
+    return shards_.size();
+}
+
+size_t ShardCoordinator::GetAliveShardsCount() const {
+    return count_if(shards_.begin(), shards_.end(), [](const ShardConnection& connection) {
+        return connection.fd >= 0;
+        });
+}
+
+void ShardCoordinator::AddDocument(int document_id, string_view document, DocumentStatus status, const vector<int>& ratings) {
+
+    MessageWriter writer;
+    writer.PutInt(document_id).PutUint(static_cast<uint64_t>(status)).PutUint(ratings.size());
+    for (const int rating : ratings) {
+        writer.PutInt(rating);
+    }
+    writer.PutString(document);
+
+    ExchangeWithShard(GetShardIndex(document_id), { ShardMessageType::ADD_DOCUMENT, writer.GetData() });
+}
+
+void ShardCoordinator::RemoveDocument(int document_id) {
+    MessageWriter writer;
+    writer.PutInt(document_id);
+    ExchangeWithShard(GetShardIndex(document_id), { ShardMessageType::REMOVE_DOCUMENT, writer.GetData() });
+}
+
+ShardedSearchResult ShardCoordinator::FindTopDocuments(string_view raw_query, DocumentStatus status) {
+    return move(FindTopDocuments(vector<string>{ string(raw_query) }, status).front());
+}
+
+vector<ShardedSearchResult> ShardCoordinator::FindTopDocuments(const vector<string>& raw_queries, DocumentStatus status) {
+
+    TRACE_SPAN("ShardCoordinatorFindTopDocuments");
+
+    //  1:     
+    vector<vector<ShardRequest>> stats_requests(shards_.size());
+    for (const string& raw_query : raw_queries) {
+        MessageWriter writer;
+        writer.PutString(raw_query);
+        for (auto& requests : stats_requests) {
+            requests.push_back({ ShardMessageType::COLLECT_STATS, writer.GetData() });
+        }
+    }
+    const vector<ShardReplies> stats_replies = Exchange(stats_requests, chrono::steady_clock::now() + timeout_);
+
+    //  2:      ,  
+    vector<vector<ShardRequest>> find_requests(shards_.size());
+    // find_queries[shard] -  ,     2
+    vector<vector<size_t>> find_queries(shards_.size());
+    for (size_t query = 0; query < raw_queries.size(); ++query) {
+        CorpusStats corpus_stats;
+        map<string, size_t, less<>> documents_freqs;
+        vector<size_t> responded_shards;
+
+        for (size_t shard = 0; shard < shards_.size(); ++shard) {
+            const optional<ShardFrame>& reply = stats_replies[shard][query];
+            if (!reply)
+            {
+                continue;
+            }
+            if (reply->type != ShardMessageType::STATS)
+            {
+                ThrowShardError(*reply);
+            }
+
+            MessageReader reader(reply->payload);
+            corpus_stats.documents_count += reader.GetUint();
+            corpus_stats.words_count += reader.GetUint();
+            for (uint64_t words_count = reader.GetUint(); words_count > 0; --words_count) {
+                const string_view word = reader.GetString();
+                auto freq_it = documents_freqs.find(word);
+                if (freq_it == documents_freqs.end())
+                {
+                    freq_it = documents_freqs.emplace(word, 0).first;
+                }
+                freq_it->second += reader.GetUint();
+            }
+            responded_shards.push_back(shard);
+        }
+
+        MessageWriter writer;
+        writer.PutString(raw_queries[query])
+            .PutUint(static_cast<uint64_t>(status))
+            .PutUint(corpus_stats.documents_count)
+            .PutUint(corpus_stats.words_count)
+            .PutUint(documents_freqs.size());
+        for (const auto& [word, document_freq] : documents_freqs) {
+            writer.PutString(word).PutUint(document_freq);
+        }
+        for (const size_t shard : responded_shards) {
+            find_requests[shard].push_back({ ShardMessageType::FIND_TOP_DOCUMENTS, writer.GetData() });
+            find_queries[shard].push_back(query);
+        }
+    }
+    // ,     1,    2:   
+    const vector<ShardReplies> find_replies = Exchange(find_requests, chrono::steady_clock::now() + timeout_);
+
+    vector<vector<vector<Document>>> queries_documents(raw_queries.size());
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        for (size_t i = 0; i < find_queries[shard].size(); ++i) {
+            const optional<ShardFrame>& reply = find_replies[shard][i];
+            if (!reply)
+            {
+                continue;
+            }
+            if (reply->type != ShardMessageType::DOCUMENTS)
+            {
+                ThrowShardError(*reply);
+            }
+
+            MessageReader reader(reply->payload);
+            //    ,       
+            vector<Document>& documents = queries_documents[find_queries[shard][i]].emplace_back();
+            for (uint64_t documents_count = reader.GetUint(); documents_count > 0; --documents_count) {
+                Document& document = documents.emplace_back();
+                document.id = static_cast<int>(reader.GetInt());
+                document.relevance = reader.GetDouble();
+                document.rating = static_cast<int>(reader.GetInt());
+            }
+        }
+    }
+
+    vector<ShardedSearchResult> results(raw_queries.size());
+    for (size_t query = 0; query < raw_queries.size(); ++query) {
+        results[query].documents = MergeTopDocuments(queries_documents[query]);
+        results[query].missing_shards = shards_.size() - queries_documents[query].size();
+    }
+    return results;
+}
+
+vector<ShardCoordinator::ShardReplies> ShardCoordinator::Exchange(const vector<vector<ShardRequest>>& requests, chrono::steady_clock::time_point deadline) {
+
+    vector<ShardReplies> replies(shards_.size());
+    // id      ; id    
+    vector<uint32_t> first_request_ids(shards_.size());
+    vector<size_t> pending_replies(shards_.size());
+    size_t pending_count = 0;
+
+    for (size_t shard = 0; shard < shards_.size(); ++shard) {
+        ShardConnection& connection = shards_[shard];
+        replies[shard].resize(requests[shard].size());
+        first_request_ids[shard] = next_request_id_;
+        if (connection.fd < 0)
+        {
+            continue;
+        }
+        for (const ShardRequest& request : requests[shard]) {
+            connection.output += EncodeShardFrame(request.type, next_request_id_++, request.payload);
+        }
+        FlushOutput(connection);
+        if (connection.fd >= 0)
+        {
+            pending_replies[shard] = requests[shard].size();
+            pending_count += requests[shard].size();
+        }
+    }
+
+    vector<pollfd> poll_fds;
+    vector<size_t> poll_shards;
+    char buffer[64 * 1024];
+
+    while (pending_count > 0) {
+        const auto now = chrono::steady_clock::now();
+        if (now >= deadline)
+        {
+            break;
+        }
+
+        poll_fds.clear();
+        poll_shards.clear();
+        for (size_t shard = 0; shard < shards_.size(); ++shard) {
+            const ShardConnection& connection = shards_[shard];
+            if (connection.fd >= 0 && pending_replies[shard] > 0)
+            {
+                poll_fds.push_back({ connection.fd, static_cast<short>(POLLIN | (connection.output.empty() ? 0 : POLLOUT)), 0 });
+                poll_shards.push_back(shard);
+            }
+        }
+        if (poll_fds.empty())
+        {
+            break;
+        }
+
+        const auto wait = chrono::ceil<chrono::milliseconds>(deadline - now);
+        if (poll(poll_fds.data(), poll_fds.size(), static_cast<int>(wait.count())) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw system_error(errno, generic_category(), "poll"s);
+        }
+
+        for (size_t i = 0; i < poll_fds.size(); ++i) {
+            const size_t shard = poll_shards[i];
+            ShardConnection& connection = shards_[shard];
+
+            bool closed = false;
+            if (poll_fds[i].revents & POLLOUT)
+            {
+                FlushOutput(connection);
+                closed = connection.fd < 0;
+            }
+            while (!closed && (poll_fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                const ssize_t received = recv(connection.fd, buffer, sizeof(buffer), 0);
+                if (received > 0)
+                {
+                    connection.input.Append(buffer, static_cast<size_t>(received));
+                    continue;
+                }
+                if (received < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                closed = received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+                break;
+            }
+
+            try {
+                while (auto reply = connection.input.PopFrame()) {
+                    const uint32_t index = reply->request_id - first_request_ids[shard];
+                    if (index < replies[shard].size() && !replies[shard][index])
+                    {
+                        replies[shard][index] = move(*reply);
+                        --pending_replies[shard];
+                        --pending_count;
+                    }
+                }
+            }
+            catch (const exception&) {
+                closed = true;
+            }
+
+            //         
+            if (closed)
+            {
+                CloseConnection(connection);
+                pending_count -= pending_replies[shard];
+                pending_replies[shard] = 0;
+            }
+        }
+    }
+
+    return replies;
+}
+
+ShardFrame ShardCoordinator::ExchangeWithShard(size_t shard, ShardRequest request) {
+
+    vector<vector<ShardRequest>> requests(shards_.size());
+    requests[shard].push_back(move(request));
+
+    vector<ShardReplies> replies = Exchange(requests, chrono::steady_clock::now() + timeout_);
+    optional<ShardFrame>& reply = replies[shard].front();
+    if (!reply)
+    {
+        throw runtime_error("Shard "s + to_string(shard) + " did not respond"s);
+    }
+    if (reply->type == ShardMessageType::ERROR)
+    {
+        ThrowShardError(*reply);
+    }
+    return move(*reply);
+}
+
+void ShardCoordinator::FlushOutput(ShardConnection& connection) {
+    size_t sent_size = 0;
+    while (sent_size < connection.output.size()) {
+        const ssize_t sent = send(connection.fd, connection.output.data() + sent_size, connection.output.size() - sent_size, MSG_NOSIGNAL);
+        if (sent > 0)
+        {
+            sent_size += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        CloseConnection(connection);
+        return;
+    }
+    connection.output.erase(0, sent_size);
+}
+
+void ShardCoordinator::CloseConnection(ShardConnection& connection) {
+    if (connection.fd >= 0)
+    {
+        close(connection.fd);
+    }
+    connection.fd = -1;
+    connection.output.clear();
+    connection.input = ShardFrameBuffer();
+}
+
+size_t ShardCoordinator::GetShardIndex(int document_id) const {
+    return hash<int>()(document_id) % shards_.size();
+}
+
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "document.h"
+#include "shard_protocol.h"
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ShardedSearchResult {
+    std::vector<Document> documents;
+    // ,     ;     
+    size_t missing_shards = 0;
+};
+
+/**
+ *  ,    (RunShardWorker, StartLocalShards).
+ *
+ *       id,   ShardedSearchServer.  
+ *   :        ,  
+ *   ,  IDF     ( TF-IDF).
+ *       ,  
+ * . ,     timeout    , :
+ *    ,      missing_shards.
+ *
+ *  auto shards = StartLocalShards(4, "/tmp"s, "./shard"s, "and in on"sv);
+ *  ShardCoordinator coordinator({ shards[0].socket_path, ... }, 100ms);
+ *  coordinator.AddDocument(1, "curly cat"sv, DocumentStatus::ACTUAL, { 1 });
+ *  coordinator.FindTopDocuments("cat"sv);
+ */
+class ShardCoordinator {
+public:
+    //    ; ,    ,   timeout
+    ShardCoordinator(const std::vector<std::string>& socket_paths, std::chrono::milliseconds timeout);
+    ~ShardCoordinator();
+
+    ShardCoordinator(const ShardCoordinator&) = delete;
+    ShardCoordinator& operator=(const ShardCoordinator&) = delete;
+
+    size_t GetShardsCount() const;
+
+    // ,     
+    size_t GetAliveShardsCount() const;
+
+    //       ; runtime_error,    
+    void AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings);
+    void RemoveDocument(int document_id);
+
+    ShardedSearchResult FindTopDocuments(std::string_view raw_query, DocumentStatus status = DocumentStatus::ACTUAL);
+    //        ;    
+    std::vector<ShardedSearchResult> FindTopDocuments(const std::vector<std::string>& raw_queries, DocumentStatus status = DocumentStatus::ACTUAL);
+
+private:
+    struct ShardConnection {
+        int fd = -1;
+        //    ;   ,    
+        std::string output;
+        ShardFrameBuffer input;
+    };
+
+    struct ShardRequest {
+        ShardMessageType type;
+        std::string payload;
+    };
+
+    //       ;  -   
+    using ShardReplies = std::vector<std::optional<ShardFrame>>;
+
+    std::vector<ShardConnection> shards_;
+
+    std::chrono::milliseconds timeout_;
+
+    uint32_t next_request_id_ = 0;
+
+private:
+    //         deadline;
+    //     ,   , 
+    std::vector<ShardReplies> Exchange(const std::vector<std::vector<ShardRequest>>& requests, std::chrono::steady_clock::time_point deadline);
+
+    //   ;       
+    ShardFrame ExchangeWithShard(size_t shard, ShardRequest request);
+
+    //   ,    
+    void FlushOutput(ShardConnection& connection);
+
+    void CloseConnection(ShardConnection& connection);
+
+    // ,   
+    size_t GetShardIndex(int document_id) const;
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "shard_protocol.h"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+static void PutFixed(string& data, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static uint64_t GetFixed(const char* data, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+MessageWriter& MessageWriter::PutUint(uint64_t value) {
+    while (value >= 0x80) {
+        data_.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+    return *this;
+}
+
+MessageWriter& MessageWriter::PutInt(int64_t value) {
+    // zigzag: ,   ,      
+    return PutUint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+MessageWriter& MessageWriter::PutDouble(double value) {
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    PutFixed(data_, bits, sizeof(bits));
+    return *this;
+}
+
+MessageWriter& MessageWriter::PutString(string_view value) {
+    PutUint(value.size());
+    data_.append(value);
+    return *this;
+}
+
+uint64_t MessageReader::GetUint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (data_.empty())
+        {
+            throw runtime_error("Truncated shard message"s);
+        }
+        const uint8_t byte = static_cast<uint8_t>(data_.front());
+        data_.remove_prefix(1);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return value;
+        }
+    }
+    throw runtime_error("Invalid varint in shard message"s);
+}
+
+int64_t MessageReader::GetInt() {
+    const uint64_t value = GetUint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+double MessageReader::GetDouble() {
+    if (data_.size() < sizeof(uint64_t))
+    {
+        throw runtime_error("Truncated shard message"s);
+    }
+    const uint64_t bits = GetFixed(data_.data(), sizeof(bits));
+    data_.remove_prefix(sizeof(bits));
+
+    double value = 0.;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+string_view MessageReader::GetString() {
+    const uint64_t size = GetUint();
+    if (size > data_.size())
+    {
+        throw runtime_error("Truncated shard message"s);
+    }
+    const string_view value = data_.substr(0, size);
+    data_.remove_prefix(size);
+    return value;
+}
+
+string EncodeShardFrame(ShardMessageType type, uint32_t request_id, string_view payload) {
+    string frame;
+    frame.reserve(SHARD_FRAME_HEADER_SIZE + payload.size());
+    PutFixed(frame, payload.size(), 4);
+    frame.push_back(static_cast<char>(type));
+    PutFixed(frame, request_id, 4);
+    frame.append(payload);
+    return frame;
+}
+
+void ShardFrameBuffer::Append(const char* data, size_t size) {
+    //    ,     
+    if (offset_ > 0 && offset_ * 2 >= buffer_.size())
+    {
+        buffer_.erase(0, offset_);
+        offset_ = 0;
+    }
+    buffer_.append(data, size);
+}
+
+optional<ShardFrame> ShardFrameBuffer::PopFrame() {
+    if (buffer_.size() - offset_ < SHARD_FRAME_HEADER_SIZE)
+    {
+        return nullopt;
+    }
+
+    const char* header = buffer_.data() + offset_;
+    const size_t payload_size = GetFixed(header, 4);
+    if (payload_size > MAX_SHARD_FRAME_SIZE)
+    {
+        throw runtime_error("Shard frame is too large"s);
+    }
+    if (buffer_.size() - offset_ < SHARD_FRAME_HEADER_SIZE + payload_size)
+    {
+        return nullopt;
+    }
+
+    ShardFrame frame;
+    frame.type = static_cast<ShardMessageType>(header[4]);
+    frame.request_id = static_cast<uint32_t>(GetFixed(header + 5, 4));
+    frame.payload.assign(header + SHARD_FRAME_HEADER_SIZE, payload_size);
+    offset_ += SHARD_FRAME_HEADER_SIZE + payload_size;
+    return frame;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ *       .
+ *
+ * :    (4 ),   (1 ), id  (4 ),
+ *   .  - little-endian.     
+ * varint ( - zigzag), double - 8 ,  -   .
+ *    id ,     ,
+ *     .
+ *
+ *  ADD_DOCUMENT        id, status,  , ,     -> OK
+ *  REMOVE_DOCUMENT     id                                              -> OK
+ *  COLLECT_STATS                 -> STATS: documents_count, words_count,  , [, df]
+ *  FIND_TOP_DOCUMENTS  , status, documents_count, words_count,  , [, df]
+ *                                      -> DOCUMENTS: , [id, relevance, rating]
+ *                           -> ERROR:  , 
+ */
+
+enum class ShardMessageType : uint8_t {
+    //  
+    ADD_DOCUMENT = 1,
+    REMOVE_DOCUMENT = 2,
+    COLLECT_STATS = 3,
+    FIND_TOP_DOCUMENTS = 4,
+    //  
+    OK = 64,
+    STATS = 65,
+    DOCUMENTS = 66,
+    ERROR = 67,
+};
+
+//  ,    ERROR
+enum class ShardErrorKind : uint8_t {
+    INVALID_ARGUMENT = 0,
+    OUT_OF_RANGE = 1,
+    OTHER = 2,
+};
+
+//   
+const size_t SHARD_FRAME_HEADER_SIZE = 9;
+
+//    
+const size_t MAX_SHARD_FRAME_SIZE = 64u << 20;
+
+struct ShardFrame {
+    ShardMessageType type = ShardMessageType::OK;
+    uint32_t request_id = 0;
+    std::string payload;
+};
+
+//    
+class MessageWriter {
+public:
+    MessageWriter& PutUint(uint64_t value);
+    MessageWriter& PutInt(int64_t value);
+    MessageWriter& PutDouble(double value);
+    MessageWriter& PutString(std::string_view value);
+
+    const std::string& GetData() const {
+        return data_;
+    }
+
+private:
+    std::string data_;
+};
+
+//    ;     runtime_error
+class MessageReader {
+public:
+    explicit MessageReader(std::string_view data)
+        : data_(data) {
+    }
+
+    uint64_t GetUint();
+    int64_t GetInt();
+    double GetDouble();
+    //   ,   
+    std::string_view GetString();
+
+private:
+    std::string_view data_;
+};
+
+//  :    
+std::string EncodeShardFrame(ShardMessageType type, uint32_t request_id, std::string_view payload);
+
+//  ,   ,      
+class ShardFrameBuffer {
+public:
+    void Append(const char* data, size_t size);
+
+    //   ; ,      
+    //  runtime_error,      
+    std::optional<ShardFrame> PopFrame();
+
+private:
+    std::string buffer_;
+    //     
+    size_t offset_ = 0;
+};
@@ -0,0 +1,343 @@
+#include "shard_worker.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+//  ,     
+class QueryCorpusStats : public CorpusStatsSource {
+public:
+    explicit QueryCorpusStats(MessageReader& reader) {
+        corpus_stats_.documents_count = reader.GetUint();
+        corpus_stats_.words_count = reader.GetUint();
+        for (uint64_t words_count = reader.GetUint(); words_count > 0; --words_count) {
+            const string_view word = reader.GetString();
+            documents_freqs_[word] = reader.GetUint();
+        }
+    }
+
+    const CorpusStats& GetCorpusStats() const override {
+        return corpus_stats_;
+    }
+
+    size_t GetDocumentFrequency(string_view word) const override {
+        //     ,    ,    1
+        const auto freq_it = documents_freqs_.find(word);
+        return freq_it == documents_freqs_.end() ? 1 : freq_it->second;
+    }
+
+private:
+    CorpusStats corpus_stats_;
+    //      
+    map<string_view, size_t> documents_freqs_;
+};
+
+static string HandleRequestPayload(SearchServer& search_server, const ShardFrame& request, ShardMessageType& reply_type) {
+
+    MessageReader reader(request.payload);
+    MessageWriter writer;
+
+    switch (request.type) {
+    case ShardMessageType::ADD_DOCUMENT:
+    {
+        const int document_id = static_cast<int>(reader.GetInt());
+        const DocumentStatus status = static_cast<DocumentStatus>(reader.GetUint());
+        //     :     ,   
+        //    ,     
+        vector<int> ratings;
+        for (uint64_t ratings_count = reader.GetUint(); ratings_count > 0; --ratings_count) {
+            ratings.push_back(static_cast<int>(reader.GetInt()));
+        }
+        search_server.AddDocument(document_id, reader.GetString(), status, ratings);
+        reply_type = ShardMessageType::OK;
+        break;
+    }
+    case ShardMessageType::REMOVE_DOCUMENT:
+        search_server.RemoveDocument(static_cast<int>(reader.GetInt()));
+        reply_type = ShardMessageType::OK;
+        break;
+    case ShardMessageType::COLLECT_STATS:
+    {
+        const auto documents_freqs = search_server.GetQueryDocumentFrequencies(reader.GetString());
+        writer.PutUint(search_server.GetCorpusStats().documents_count)
+            .PutUint(search_server.GetCorpusStats().words_count)
+            .PutUint(documents_freqs.size());
+        for (const auto& [word, document_freq] : documents_freqs) {
+            writer.PutString(word).PutUint(document_freq);
+        }
+        reply_type = ShardMessageType::STATS;
+        break;
+    }
+    case ShardMessageType::FIND_TOP_DOCUMENTS:
+    {
+        const string_view raw_query = reader.GetString();
+        const DocumentStatus status = static_cast<DocumentStatus>(reader.GetUint());
+        const QueryCorpusStats corpus_stats(reader);
+
+        //     ,  
+        vector<Document> documents;
+        search_server.SetCorpusStatsSource(&corpus_stats);
+        try {
+            search_server.FindTopDocuments(raw_query, status, documents);
+        }
+        catch (...) {
+            search_server.SetCorpusStatsSource(nullptr);
+            throw;
+        }
+        search_server.SetCorpusStatsSource(nullptr);
+
+        writer.PutUint(documents.size());
+        for (const Document& document : documents) {
+            writer.PutInt(document.id).PutDouble(document.relevance).PutInt(document.rating);
+        }
+        reply_type = ShardMessageType::DOCUMENTS;
+        break;
+    }
+    default:
+        throw invalid_argument("Unknown shard request type"s);
+    }
+
+    return writer.GetData();
+}
+
+string HandleShardRequest(SearchServer& search_server, const ShardFrame& request) {
+
+    ShardErrorKind error_kind = ShardErrorKind::OTHER;
+    string error_message;
+    try {
+        ShardMessageType reply_type = ShardMessageType::OK;
+        const string payload = HandleRequestPayload(search_server, request, reply_type);
+        return EncodeShardFrame(reply_type, request.request_id, payload);
+    }
+    catch (const invalid_argument& e) {
+        error_kind = ShardErrorKind::INVALID_ARGUMENT;
+        error_message = e.what();
+    }
+    catch (const out_of_range& e) {
+        error_kind = ShardErrorKind::OUT_OF_RANGE;
+        error_message = e.what();
+    }
+    catch (const exception& e) {
+        error_message = e.what();
+    }
+
+    MessageWriter writer;
+    writer.PutUint(static_cast<uint8_t>(error_kind)).PutString(error_message);
+    return EncodeShardFrame(ShardMessageType::ERROR, request.request_id, writer.GetData());
+}
+
+static bool SendAll(int fd, string_view data) {
+    while (!data.empty()) {
+        const ssize_t sent = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (sent <= 0)
+        {
+            return false;
+        }
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+    return true;
+}
+
+void ServeShardConnection(int connection_fd, SearchServer& search_server) {
+
+    ShardFrameBuffer input;
+    string output;
+    char buffer[64 * 1024];
+
+    while (true) {
+        const ssize_t received = recv(connection_fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            return;
+        }
+        input.Append(buffer, static_cast<size_t>(received));
+
+        //         
+        output.clear();
+        try {
+            while (auto request = input.PopFrame()) {
+                output += HandleShardRequest(search_server, *request);
+            }
+        }
+        catch (const exception&) {
+            //   :  
+            return;
+        }
+        if (!SendAll(connection_fd, output))
+        {
+            return;
+        }
+    }
+}
+
+int ListenShardSocket(const string& socket_path) {
+
+    sockaddr_un address = {};
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        throw invalid_argument("Shard socket path is too long"s);
+    }
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, socket_path.data(), socket_path.size());
+
+    const int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0)
+    {
+        throw system_error(errno, generic_category(), "socket"s);
+    }
+
+    unlink(socket_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0
+        || listen(listen_fd, SOMAXCONN) < 0)
+    {
+        const int error = errno;
+        close(listen_fd);
+        throw system_error(error, generic_category(), "Cannot listen on "s + socket_path);
+    }
+
+    return listen_fd;
+}
+
+void ServeShard(int listen_fd, SearchServer& search_server) {
+    while (true) {
+        const int connection_fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection_fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            throw system_error(errno, generic_category(), "accept"s);
+        }
+        ServeShardConnection(connection_fd, search_server);
+        close(connection_fd);
+    }
+}
+
+void RunShardWorker(const string& socket_path, SearchServer& search_server) {
+    ServeShard(ListenShardSocket(socket_path), search_server);
+}
+
+vector<ShardProcess> StartLocalShards(size_t shards_count, const string& socket_dir, const string& worker_path,
+    string_view stop_words_text, bool positional_index) {
+
+    vector<ShardProcess> shards;
+    shards.reserve(shards_count);
+
+    try {
+        for (size_t i = 0; i < shards_count; ++i) {
+            ShardProcess& shard = shards.emplace_back();
+            shard.socket_path = socket_dir + "/shard"s + to_string(i) + ".sock"s;
+            const int listen_fd = ListenShardSocket(shard.socket_path);
+
+            //    fork:       
+            const vector<string> arguments = {
+                worker_path,
+                "--listen-fd="s + to_string(listen_fd),
+                "--stop-words="s + string(stop_words_text),
+                "--positions="s + (positional_index ? "1"s : "0"s),
+            };
+            vector<char*> argv;
+            for (const string& argument : arguments) {
+                argv.push_back(const_cast<char*>(argument.c_str()));
+            }
+            argv.push_back(nullptr);
+
+            //       exec;   exec  
+            int exec_pipe[2];
+            if (pipe2(exec_pipe, O_CLOEXEC) < 0)
+            {
+                const int error = errno;
+                close(listen_fd);
+                throw system_error(error, generic_category(), "pipe"s);
+            }
+
+            shard.pid = fork();
+            if (shard.pid == 0)
+            {
+                //     SOCK_CLOEXEC,      
+                int exec_error = 0;
+                if (fcntl(listen_fd, F_SETFD, 0) < 0)
+                {
+                    exec_error = errno;
+                }
+                else
+                {
+                    execv(argv[0], argv.data());
+                    exec_error = errno;
+                }
+                [[maybe_unused]] const ssize_t written = write(exec_pipe[1], &exec_error, sizeof(exec_error));
+                _exit(127);
+            }
+
+            const int fork_error = errno;
+            close(listen_fd);
+            close(exec_pipe[1]);
+            if (shard.pid < 0)
+            {
+                close(exec_pipe[0]);
+                throw system_error(fork_error, generic_category(), "fork"s);
+            }
+
+            int exec_error = 0;
+            ssize_t read_size;
+            do {
+                read_size = read(exec_pipe[0], &exec_error, sizeof(exec_error));
+            } while (read_size < 0 && errno == EINTR);
+            close(exec_pipe[0]);
+            if (read_size > 0)
+            {
+                waitpid(shard.pid, nullptr, 0);
+                shard.pid = -1;
+                throw system_error(exec_error, generic_category(), "Cannot start shard worker "s + worker_path);
+            }
+        }
+    }
+    catch (...) {
+        StopLocalShards(shards);
+        throw;
+    }
+
+    return shards;
+}
+
+void StopLocalShards(vector<ShardProcess>& shards) {
+    for (const ShardProcess& shard : shards) {
+        if (shard.pid > 0)
+        {
+            kill(shard.pid, SIGTERM);
+        }
+    }
+    for (const ShardProcess& shard : shards) {
+        if (shard.pid > 0)
+        {
+            waitpid(shard.pid, nullptr, 0);
+        }
+        unlink(shard.socket_path.c_str());
+    }
+    shards.clear();
+}
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "search_server.h"
+#include "shard_protocol.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/types.h>
+
+/**
+ *  : SearchServer,    (ShardCoordinator)
+ *  Unix-.      ,   
+ *   id ;   ,    .
+ *
+ *  SearchServer search_server("and in on"sv);
+ *  RunShardWorker("/tmp/shard0.sock"s, search_server);
+ */
+
+//     ;     ERROR
+std::string HandleShardRequest(SearchServer& search_server, const ShardFrame& request);
+
+//    ,     
+void ServeShardConnection(int connection_fd, SearchServer& search_server);
+
+//  Unix-   socket_path;    
+int ListenShardSocket(const std::string& socket_path);
+
+//          ;   
+void ServeShard(int listen_fd, SearchServer& search_server);
+void RunShardWorker(const std::string& socket_path, SearchServer& search_server);
+
+struct ShardProcess {
+    pid_t pid = -1;
+    std::string socket_path;
+};
+
+//  shards_count     socket_dir/shard<N>.sock;
+//     ,      .
+//   -   worker_path (shard/shard.cpp),   fork  exec:
+//      exec   ,   
+std::vector<ShardProcess> StartLocalShards(size_t shards_count, const std::string& socket_dir, const std::string& worker_path,
+    std::string_view stop_words_text = {}, bool positional_index = false);
+
+//       
+void StopLocalShards(std::vector<ShardProcess>& shards);
+
+#endif
@@ -0,0 +1,257 @@
+#include "sharded_search_server.h"
+
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+ShardedSearchServer::ShardedSearchServer(size_t shards_count, string_view stop_words_text)
+    : stop_words_text_(stop_words_text) {
+
+    if (shards_count == 0)
+    {
+        throw invalid_argument("Shards count must be positive"s);
+    }
+
+    shards_ = CreateShards(shards_count);
+}
+
+size_t ShardedSearchServer::GetShardsCount() const {
+    return shards_.size();
+}
+
+size_t ShardedSearchServer::GetDocumentCount() const {
+    return corpus_stats_.documents_count;
+}
+
+const CorpusStats& ShardedSearchServer::GetCorpusStats() const {
+    return corpus_stats_;
+}
+
+void ShardedSearchServer::SetPositionalIndex(bool enabled) {
+    positional_index_enabled_ = enabled;
+    for (SearchServer& shard : shards_) {
+        shard.SetPositionalIndex(enabled);
+    }
+}
+
+void ShardedSearchServer::SetFuzzyMatching(const FuzzyMatching& fuzzy_matching) {
+    for (SearchServer& shard : shards_) {
+        shard.SetFuzzyMatching(fuzzy_matching);
+    }
+    fuzzy_matching_ = fuzzy_matching;
+}
+
+void ShardedSearchServer::SetDocumentStore(const DocumentStoreConfig& config) {
+    for (SearchServer& shard : shards_) {
+        shard.SetDocumentStore(config);
+    }
+    document_store_config_ = config;
+}
+
+string ShardedSearchServer::GetDocumentText(int document_id) const {
+    return shards_[GetShardIndex(document_id, shards_.size())].GetDocumentText(document_id);
+}
+
+void ShardedSearchServer::AddDocument(int document_id, string_view document, DocumentStatus status, const vector<int>& ratings) {
+
+    SearchServer& shard = shards_[GetShardIndex(document_id, shards_.size())];
+    const size_t shard_words_count = shard.GetCorpusStats().words_count;
+
+    //  id    ;     id     
+    shard.AddDocument(document_id, document, status, ratings);
+
+    ++corpus_stats_.documents_count;
+    corpus_stats_.words_count += shard.GetCorpusStats().words_count - shard_words_count;
+
+    for (const auto& [word, term_freq] : shard.GetWordFrequencies(document_id)) {
+        ++documents_freqs_.Insert(word).first.value;
+    }
+}
+
+void ShardedSearchServer::RemoveDocument(int document_id) {
+
+    SearchServer& shard = shards_[GetShardIndex(document_id, shards_.size())];
+    const CorpusStats shard_stats = shard.GetCorpusStats();
+
+    //    ,      
+    const auto& words_freqs = shard.GetWordFrequencies(document_id);
+    for (const auto& [word, term_freq] : words_freqs) {
+        if (--*documents_freqs_.Find(word) == 0)
+        {
+            documents_freqs_.Erase(word);
+        }
+    }
+
+    shard.RemoveDocument(document_id);
+
+    corpus_stats_.documents_count -= shard_stats.documents_count - shard.GetCorpusStats().documents_count;
+    corpus_stats_.words_count -= shard_stats.words_count - shard.GetCorpusStats().words_count;
+}
+
+void ShardedSearchServer::RemoveDocuments(const vector<int>& document_ids) {
+
+    //     ;     
+    vector<int> removed_ids(document_ids);
+    sort(removed_ids.begin(), removed_ids.end());
+    removed_ids.erase(unique(removed_ids.begin(), removed_ids.end()), removed_ids.end());
+
+    //    ;    ,     
+    vector<vector<int>> shards_ids(shards_.size());
+    for (const int document_id : removed_ids) {
+        const size_t shard_index = GetShardIndex(document_id, shards_.size());
+        for (const auto& [word, term_freq] : shards_[shard_index].GetWordFrequencies(document_id)) {
+            if (--*documents_freqs_.Find(word) == 0)
+            {
+                documents_freqs_.Erase(word);
+            }
+        }
+        shards_ids[shard_index].push_back(document_id);
+    }
+
+    vector<CorpusStats> shards_stats(shards_.size());
+    vector<size_t> shards_indexes(shards_.size());
+    iota(shards_indexes.begin(), shards_indexes.end(), 0);
+    for_each(execution::par, shards_indexes.begin(), shards_indexes.end(), [&](size_t i) {
+        shards_stats[i] = shards_[i].GetCorpusStats();
+        shards_[i].RemoveDocuments(execution::seq, shards_ids[i]);
+        });
+
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        corpus_stats_.documents_count -= shards_stats[i].documents_count - shards_[i].GetCorpusStats().documents_count;
+        corpus_stats_.words_count -= shards_stats[i].words_count - shards_[i].GetCorpusStats().words_count;
+    }
+}
+
+void ShardedSearchServer::UpdateDocument(int document_id, string_view document, DocumentStatus status, const vector<int>& ratings) {
+
+    SearchServer& shard = shards_[GetShardIndex(document_id, shards_.size())];
+    const size_t shard_words_count = shard.GetCorpusStats().words_count;
+
+    //   : ,   ,      
+    vector<string> old_words;
+    for (const auto& [word, term_freq] : shard.GetWordFrequencies(document_id)) {
+        old_words.emplace_back(word);
+    }
+
+    shard.UpdateDocument(document_id, document, status, ratings);
+
+    corpus_stats_.words_count = corpus_stats_.words_count - shard_words_count + shard.GetCorpusStats().words_count;
+
+    //     ,        
+    const auto& words_freqs = shard.GetWordFrequencies(document_id);
+    auto old_word = old_words.begin();
+    auto new_word = words_freqs.begin();
+    while (old_word != old_words.end() || new_word != words_freqs.end()) {
+        if (new_word == words_freqs.end() || (old_word != old_words.end() && *old_word < new_word->first))
+        {
+            if (--*documents_freqs_.Find(*old_word) == 0)
+            {
+                documents_freqs_.Erase(*old_word);
+            }
+            ++old_word;
+        }
+        else if (old_word == old_words.end() || new_word->first < *old_word)
+        {
+            ++documents_freqs_.Insert(new_word->first).first.value;
+            ++new_word;
+        }
+        else
+        {
+            ++old_word;
+            ++new_word;
+        }
+    }
+}
+
+vector<Document> ShardedSearchServer::FindTopDocuments(string_view raw_query) const {
+    return FindTopDocuments(execution::par, raw_query);
+}
+
+MatchDocumentData ShardedSearchServer::MatchDocument(string_view raw_query, int document_id) const {
+    return shards_[GetShardIndex(document_id, shards_.size())].MatchDocument(raw_query, document_id);
+}
+
+void ShardedSearchServer::Rebalance(size_t shards_count) {
+
+    if (shards_count == 0)
+    {
+        throw invalid_argument("Shards count must be positive"s);
+    }
+
+    //    :     
+    vector<SearchServer> shards = CreateShards(shards_count);
+    for (SearchServer& shard : shards_) {
+        const vector<int> documents_ids(shard.begin(), shard.end());
+        for (const int document_id : documents_ids) {
+            shard.MoveDocument(document_id, shards[GetShardIndex(document_id, shards_count)]);
+        }
+    }
+
+    shards_ = move(shards);
+}
+
+size_t ShardedSearchServer::GetDocumentFrequency(string_view word) const {
+    const size_t* document_freq = documents_freqs_.Find(word);
+    return document_freq == nullptr ? 0 : *document_freq;
+}
+
+bool ShardedSearchServer::ForEachWordWithinDistance(string_view word, uint32_t max_distance,
+    const function<void(string_view, uint32_t, size_t)>& callback) const {
+    documents_freqs_.ForEachWithinDistance(word, max_distance, [&](string_view term, uint32_t distance, size_t document_freq) {
+        callback(term, distance, document_freq);
+        });
+    return true;
+}
+
+size_t ShardedSearchServer::GetShardIndex(int document_id, size_t shards_count) {
+    return hash<int>()(document_id) % shards_count;
+}
+
+vector<SearchServer> ShardedSearchServer::CreateShards(size_t shards_count) const {
+    vector<SearchServer> shards;
+    shards.reserve(shards_count);
+    for (size_t i = 0; i < shards_count; ++i) {
+        SearchServer& shard = shards.emplace_back(string_view(stop_words_text_));
+        shard.SetPositionalIndex(positional_index_enabled_);
+        shard.SetFuzzyMatching(fuzzy_matching_);
+        shard.SetDocumentStore(document_store_config_);
+        shard.SetCorpusStatsSource(this);
+    }
+    return shards;
+}
+
+vector<Document> MergeTopDocuments(const vector<vector<Document>>& shards_documents) {
+
+    using Cursor = pair<vector<Document>::const_iterator, vector<Document>::const_iterator>;
+
+    //    ;    -   
+    vector<Cursor> cursors;
+    for (const auto& documents : shards_documents) {
+        if (!documents.empty())
+        {
+            cursors.push_back({ documents.begin(), documents.end() });
+        }
+    }
+    const auto ranks_lower = [](const Cursor& lhs, const Cursor& rhs) {
+        return SearchServer::RanksHigher(*rhs.first, *lhs.first);
+    };
+    make_heap(cursors.begin(), cursors.end(), ranks_lower);
+
+    vector<Document> result;
+    while (!cursors.empty() && result.size() < static_cast<size_t>(MAX_RESULT_DOCUMENT_COUNT)) {
+        pop_heap(cursors.begin(), cursors.end(), ranks_lower);
+        Cursor& cursor = cursors.back();
+        result.push_back(*cursor.first);
+        if (++cursor.first == cursor.second)
+        {
+            cursors.pop_back();
+        }
+        else
+        {
+            push_heap(cursors.begin(), cursors.end(), ranks_lower);
+        }
+    }
+
+    return result;
+}
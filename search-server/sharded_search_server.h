@@ -0,0 +1,171 @@
+#pragma once
+
+#include "search_server.h"
+#include "term_dictionary.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ *  ,   .
+ *
+ *     -  SearchServer -   id. 
+ *    ( execution::par - ),   
+ *  ,        .
+ * IDF         ,  
+ *     SearchServer    .
+ *
+ *  ShardedSearchServer search_server(thread::hardware_concurrency(), "and in on"sv);
+ *  search_server.AddDocument(1, "curly cat"sv, DocumentStatus::ACTUAL, { 1 });
+ *  search_server.FindTopDocuments(execution::par, "cat"sv);
+ */
+class ShardedSearchServer : private CorpusStatsSource {
+public:
+    explicit ShardedSearchServer(size_t shards_count, std::string_view stop_words_text = {});
+
+    //     
+    ShardedSearchServer(const ShardedSearchServer&) = delete;
+    ShardedSearchServer& operator=(const ShardedSearchServer&) = delete;
+
+    size_t GetShardsCount() const;
+
+    size_t GetDocumentCount() const;
+
+    //   
+    const CorpusStats& GetCorpusStats() const override;
+
+    //      
+    void SetPositionalIndex(bool enabled);
+
+    //      ;       
+    //    ,      
+    void SetFuzzyMatching(const FuzzyMatching& fuzzy_matching);
+
+    //      
+    void SetDocumentStore(const DocumentStoreConfig& config);
+
+    //      ; out_of_range,    
+    std::string GetDocumentText(int document_id) const;
+
+    void AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings);
+
+    void RemoveDocument(int document_id);
+
+    //   :      ,  - 
+    void RemoveDocuments(const std::vector<int>& document_ids);
+
+    //  ,        (. SearchServer::UpdateDocument)
+    void UpdateDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings);
+
+    // policy ,      ;   
+    // ,  requirement      
+    template <typename Policy, typename Requirement, typename Scoring = TfIdfScoring>
+    std::vector<Document> FindTopDocuments(const Policy& policy, std::string_view raw_query, Requirement requirement, const Scoring& scoring = Scoring()) const;
+    template <typename Policy>
+    std::vector<Document> FindTopDocuments(const Policy& policy, std::string_view raw_query, DocumentStatus required_status) const;
+    template <typename Policy, typename Scoring>
+    std::vector<Document> FindTopDocuments(const Policy& policy, std::string_view raw_query, DocumentStatus required_status, const Scoring& scoring) const;
+    template <typename Policy>
+    std::vector<Document> FindTopDocuments(const Policy& policy, std::string_view raw_query) const;
+    std::vector<Document> FindTopDocuments(std::string_view raw_query) const;
+
+    MatchDocumentData MatchDocument(std::string_view raw_query, int document_id) const;
+
+    //    shards_count 
+    void Rebalance(size_t shards_count);
+
+private:
+    std::string stop_words_text_;
+
+    bool positional_index_enabled_ = false;
+
+    FuzzyMatching fuzzy_matching_;
+
+    DocumentStoreConfig document_store_config_;
+
+    std::vector<SearchServer> shards_;
+
+    // word ->     
+    TermDictionary<size_t> documents_freqs_;
+
+    CorpusStats corpus_stats_;
+
+private:
+    size_t GetDocumentFrequency(std::string_view word) const override;
+
+    bool ForEachWordWithinDistance(std::string_view word, uint32_t max_distance,
+        const std::function<void(std::string_view, uint32_t, size_t)>& callback) const override;
+
+    // ,   
+    static size_t GetShardIndex(int document_id, size_t shards_count);
+
+    std::vector<SearchServer> CreateShards(size_t shards_count) const;
+};
+
+//   ,   RanksHigher,   
+std::vector<Document> MergeTopDocuments(const std::vector<std::vector<Document>>& shards_documents);
+
+template <typename Policy, typename Requirement, typename Scoring>
+std::vector<Document> ShardedSearchServer::FindTopDocuments
+(const Policy& policy, std::string_view raw_query, Requirement requirement, const Scoring& scoring) const {
+
+    using namespace std;
+
+    TRACE_SPAN("ShardedFindTopDocuments");
+
+    vector<vector<Document>> shards_documents(shards_.size());
+    // ,    ,   
+    vector<exception_ptr> shards_errors(shards_.size());
+
+    vector<size_t> shards(shards_.size());
+    iota(shards.begin(), shards.end(), 0);
+    for_each(policy, shards.begin(), shards.end(),
+        [&](size_t shard) {
+            try {
+                shards_[shard].FindTopDocuments(raw_query, requirement, shards_documents[shard], scoring);
+            }
+            catch (...) {
+                shards_errors[shard] = current_exception();
+            }
+        }
+    );
+
+    for (const exception_ptr& error : shards_errors) {
+        if (error)
+        {
+            rethrow_exception(error);
+        }
+    }
+
+    return MergeTopDocuments(shards_documents);
+}
+
+template <typename Policy>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(const Policy& policy, std::string_view raw_query, DocumentStatus required_status) const
+{
+    return FindTopDocuments(policy, raw_query,
+        [required_status](int, DocumentStatus doc_status, int)
+        {return doc_status == required_status; });
+}
+
+template <typename Policy, typename Scoring>
+std::vector<Document> ShardedSearchServer::FindTopDocuments
+(const Policy& policy, std::string_view raw_query, DocumentStatus required_status, const Scoring& scoring) const
+{
+    return FindTopDocuments(policy, raw_query,
+        [required_status](int, DocumentStatus doc_status, int)
+        {return doc_status == required_status; }, scoring);
+}
+
+template <typename Policy>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(const Policy& policy, std::string_view raw_query) const
+{
+    return FindTopDocuments(policy, raw_query, DocumentStatus::ACTUAL);
+}
@@ -0,0 +1,77 @@
+#include "stop_words.h"
+#include "memory_stats.h"
+
+using namespace std;
+
+//     
+static constexpr auto STOP_WORDS_EXAMPLE = MakeStaticStopWords("a", "and", "in", "on", "the", "with");
+static_assert(STOP_WORDS_EXAMPLE.Contains("the") && STOP_WORDS_EXAMPLE.Contains("with"));
+static_assert(!STOP_WORDS_EXAMPLE.Contains("cat") && !STOP_WORDS_EXAMPLE.Contains(""));
+
+StopWordsSet::StopWordsSet() {
+    Rebuild();
+}
+
+StopWordsSet::StopWordsSet(set<string, less<>> words)
+    : words_(move(words)) {
+    Rebuild();
+}
+
+//        ,    
+StopWordsSet::StopWordsSet(const StopWordsSet& other)
+    : words_(other.words_)
+    , static_words_(other.static_words_) {
+    Rebuild();
+}
+
+StopWordsSet& StopWordsSet::operator=(const StopWordsSet& other) {
+    if (this != &other)
+    {
+        words_ = other.words_;
+        static_words_ = other.static_words_;
+        Rebuild();
+    }
+    return *this;
+}
+
+size_t StopWordsSet::size() const {
+    return words_.size() + static_words_.size();
+}
+
+bool StopWordsSet::empty() const {
+    return size() == 0;
+}
+
+size_t StopWordsSet::GetMemoryUsage() const {
+    size_t bytes = words_.size() * GetSetNodeSize<string>();
+    for (const string& word : words_) {
+        bytes += GetStringHeapSize(word);
+    }
+    return bytes + static_words_.capacity() * sizeof(string_view) + slots_.capacity() * sizeof(string_view)
+        + displacements_.capacity() * sizeof(uint32_t);
+}
+
+void StopWordsSet::Rebuild() {
+    vector<string_view> all_words(static_words_.begin(), static_words_.end());
+    all_words.insert(all_words.end(), words_.begin(), words_.end());
+
+    vector<uint64_t> hashes(all_words.size());
+    vector<size_t> bucket_words(all_words.size());
+    displacements_.assign(StopWordsBucketCount(all_words.size()), 0);
+    vector<size_t> bucket_starts(displacements_.size() + 1);
+    size_t table_size = StopWordsTableSize(all_words.size());
+
+    //  ,        
+    while (true)
+    {
+        slots_.assign(table_size, {});
+        if (BuildStopWordsTable(all_words, all_words.size(), hashes, bucket_starts, bucket_words, displacements_.size(),
+            slots_, table_size, displacements_))
+        {
+            break;
+        }
+        table_size *= 2;
+    }
+
+    slot_mask_ = table_size - 1;
+}
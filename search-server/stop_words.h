@@ -0,0 +1,276 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ *  -     ( "hash and displace").
+ *
+ *        .   
+ *  ,          .
+ *          .
+ *
+ *  -,    ,    constexpr-:
+ *
+ *  static constexpr auto STOP_WORDS = MakeStaticStopWords("and", "in", "on");
+ *  static_assert(STOP_WORDS.Contains("in"));
+ *  SearchServer search_server(STOP_WORDS);
+ */
+
+// 64-  FNV-1a,    
+constexpr uint64_t HashStopWord(const std::string_view word) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : word) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+//        ( splitmix64)
+constexpr uint64_t MixStopWordHash(uint64_t hash, uint32_t displacement) {
+    hash += (displacement + 1ull) * 0x9e3779b97f4a7c15ull;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    return hash ^ (hash >> 31);
+}
+
+//   -  ,     
+constexpr size_t StopWordsTableSize(size_t words_count) {
+    size_t size = 1;
+    while (size < words_count * 2) {
+        size <<= 1;
+    }
+    return size;
+}
+
+//   -  ,        
+constexpr size_t StopWordsBucketCount(size_t words_count) {
+    size_t count = 1;
+    while (count * 2 < words_count) {
+        count <<= 1;
+    }
+    return count;
+}
+
+constexpr size_t StopWordBucket(uint64_t hash, size_t bucket_count) {
+    return static_cast<size_t>(hash >> 32) & (bucket_count - 1);
+}
+
+//     (  bucket_words[begin, end))   displacement;
+//    
+template <typename Words, typename Hashes, typename BucketWords, typename Slots>
+constexpr bool TryPlaceStopWordsBucket(const Words& words, const Hashes& hashes, const BucketWords& bucket_words,
+    size_t begin, size_t end, uint32_t displacement, Slots& slots, uint64_t slot_mask) {
+
+    size_t i = begin;
+    for (; i < end; ++i) {
+        auto& slot = slots[MixStopWordHash(hashes[bucket_words[i]], displacement) & slot_mask];
+        if (!slot.empty()) {
+            break;
+        }
+        slot = words[bucket_words[i]];
+    }
+
+    if (i == end) {
+        return true;
+    }
+
+    for (size_t j = begin; j < i; ++j) {
+        slots[MixStopWordHash(hashes[bucket_words[j]], displacement) & slot_mask] = {};
+    }
+    return false;
+}
+
+//      table_size   bucket_count  ( );
+//      .  [0, table_size)  ; bucket_starts -
+//   bucket_count + 1 , bucket_words -   words_count
+template <typename Words, typename Hashes, typename BucketStarts, typename BucketWords, typename Slots, typename Displacements>
+constexpr bool BuildStopWordsTable(const Words& words, size_t words_count, Hashes& hashes,
+    BucketStarts& bucket_starts, BucketWords& bucket_words, size_t bucket_count,
+    Slots& slots, size_t table_size, Displacements& displacements) {
+
+    constexpr uint32_t MAX_DISPLACEMENT = 1u << 16;
+
+    //  ,    ( ),  
+    //      
+    for (size_t bucket = 0; bucket <= bucket_count; ++bucket) {
+        bucket_starts[bucket] = 0;
+    }
+    for (size_t i = 0; i < words_count; ++i) {
+        hashes[i] = HashStopWord(words[i]);
+        ++bucket_starts[StopWordBucket(hashes[i], bucket_count) + 1];
+    }
+    size_t max_bucket_size = 0;
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        max_bucket_size = bucket_starts[bucket + 1] > max_bucket_size ? bucket_starts[bucket + 1] : max_bucket_size;
+        bucket_starts[bucket + 1] += bucket_starts[bucket];
+    }
+    // bucket_starts[bucket]    ,   
+    for (size_t i = 0; i < words_count; ++i) {
+        bucket_words[bucket_starts[StopWordBucket(hashes[i], bucket_count)]++] = i;
+    }
+    for (size_t bucket = bucket_count; bucket > 0; --bucket) {
+        bucket_starts[bucket] = bucket_starts[bucket - 1];
+    }
+    bucket_starts[0] = 0;
+
+    //    ,   
+    const uint64_t slot_mask = table_size - 1;
+    for (size_t size = max_bucket_size; size > 0; --size) {
+        for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+            if (bucket_starts[bucket + 1] - bucket_starts[bucket] != size) {
+                continue;
+            }
+            uint32_t displacement = 0;
+            while (!TryPlaceStopWordsBucket(words, hashes, bucket_words, bucket_starts[bucket], bucket_starts[bucket + 1],
+                displacement, slots, slot_mask)) {
+                if (++displacement == MAX_DISPLACEMENT) {
+                    return false;
+                }
+            }
+            displacements[bucket] = displacement;
+        }
+    }
+
+    return true;
+}
+
+//  -,      
+template <size_t N>
+class StaticStopWords {
+public:
+    static constexpr size_t TABLE_SIZE = StopWordsTableSize(N);
+    //     ,    (  ) - 
+    // ,      
+    static constexpr size_t MAX_BUCKET_COUNT = StopWordsBucketCount(N) * 4;
+
+    constexpr explicit StaticStopWords(const std::array<std::string_view, N>& words)
+        : words_(words) {
+
+        std::array<uint64_t, N> hashes{};
+        std::array<size_t, MAX_BUCKET_COUNT + 1> bucket_starts{};
+        std::array<size_t, N> bucket_words{};
+        for (bucket_count_ = StopWordsBucketCount(N); bucket_count_ <= MAX_BUCKET_COUNT; bucket_count_ *= 2) {
+            for (auto& slot : slots_) {
+                slot = {};
+            }
+            if (BuildStopWordsTable(words_, N, hashes, bucket_starts, bucket_words, bucket_count_, slots_, TABLE_SIZE, displacements_)) {
+                return;
+            }
+        }
+        throw std::invalid_argument("Stop words must be unique and non-empty");
+    }
+
+    constexpr bool Contains(const std::string_view word) const {
+        const uint64_t hash = HashStopWord(word);
+        const std::string_view& slot = slots_[MixStopWordHash(hash, displacements_[StopWordBucket(hash, bucket_count_)]) & (TABLE_SIZE - 1)];
+        return !slot.empty() && slot == word;
+    }
+
+    constexpr auto begin() const {
+        return words_.begin();
+    }
+
+    constexpr auto end() const {
+        return words_.end();
+    }
+
+    constexpr const std::array<std::string_view, TABLE_SIZE>& GetSlots() const {
+        return slots_;
+    }
+
+    //   GetBucketCount() 
+    constexpr const std::array<uint32_t, MAX_BUCKET_COUNT>& GetDisplacements() const {
+        return displacements_;
+    }
+
+    constexpr size_t GetBucketCount() const {
+        return bucket_count_;
+    }
+
+private:
+    std::array<std::string_view, N> words_{};
+    std::array<std::string_view, TABLE_SIZE> slots_{};
+    std::array<uint32_t, MAX_BUCKET_COUNT> displacements_{};
+    size_t bucket_count_ = 0;
+};
+
+template <typename... Words>
+constexpr auto MakeStaticStopWords(const Words&... words) {
+    return StaticStopWords<sizeof...(Words)>(std::array<std::string_view, sizeof...(Words)>{ std::string_view(words)... });
+}
+
+//  - ;      
+class StopWordsSet {
+public:
+    StopWordsSet();
+
+    explicit StopWordsSet(std::set<std::string, std::less<>> words);
+
+    //   ,    
+    template <size_t N>
+    explicit StopWordsSet(const StaticStopWords<N>& static_words);
+
+    StopWordsSet(const StopWordsSet& other);
+    StopWordsSet(StopWordsSet&& other) = default;
+
+    StopWordsSet& operator=(const StopWordsSet& other);
+    StopWordsSet& operator=(StopWordsSet&& other) = default;
+
+    //        
+    template <typename StringRange>
+    void Insert(const StringRange& words);
+
+    bool Contains(const std::string_view word) const {
+        const uint64_t hash = HashStopWord(word);
+        const std::string_view& slot = slots_[MixStopWordHash(hash, displacements_[StopWordBucket(hash, displacements_.size())]) & slot_mask_];
+        return !slot.empty() && slot == word;
+    }
+
+    size_t size() const;
+
+    bool empty() const;
+
+    //     
+    size_t GetMemoryUsage() const;
+
+private:
+    // ,   
+    std::set<std::string, std::less<>> words_;
+
+    //  ,     (   )
+    std::vector<std::string_view> static_words_;
+
+    std::vector<std::string_view> slots_;
+    std::vector<uint32_t> displacements_;
+    uint64_t slot_mask_ = 0;
+
+private:
+    void Rebuild();
+};
+
+template <size_t N>
+StopWordsSet::StopWordsSet(const StaticStopWords<N>& static_words)
+    : static_words_(static_words.begin(), static_words.end())
+    , slots_(static_words.GetSlots().begin(), static_words.GetSlots().end())
+    , displacements_(static_words.GetDisplacements().begin(), static_words.GetDisplacements().begin() + static_words.GetBucketCount())
+    , slot_mask_(StaticStopWords<N>::TABLE_SIZE - 1) {
+
+}
+
+template <typename StringRange>
+void StopWordsSet::Insert(const StringRange& words) {
+    for (const std::string_view word : words) {
+        if (!word.empty() && !Contains(word)) {
+            words_.emplace(word);
+        }
+    }
+    Rebuild();
+}
@@ -2,10 +2,186 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <set>
+#include <iterator>
+#include <cstddef>
 
-//   (string_view)   ,     
-std::vector<std::string_view> SplitIntoWords(const std::string_view text);
+//     ,  ;   
+class WordIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    //   
+    WordIterator() = default;
+
+    //     
+    explicit WordIterator(const std::string_view text)
+        : text_(text) {
+        FindWord(0);
+    }
+
+    reference operator*() const {
+        return word_;
+    }
+
+    pointer operator->() const {
+        return &word_;
+    }
+
+    WordIterator& operator++() {
+        FindWord(static_cast<size_t>(word_.data() - text_.data()) + word_.size());
+        return *this;
+    }
+
+    WordIterator operator++(int) {
+        WordIterator prev = *this;
+        ++(*this);
+        return prev;
+    }
+
+    friend bool operator==(const WordIterator& lhs, const WordIterator& rhs) {
+        return lhs.word_.data() == rhs.word_.data() && lhs.word_.size() == rhs.word_.size();
+    }
+
+    friend bool operator!=(const WordIterator& lhs, const WordIterator& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    std::string_view text_;
+    std::string_view word_;
+
+    //   ,    pos;       
+    void FindWord(size_t pos) {
+        pos = text_.find_first_not_of(' ', pos);
+        if (pos == text_.npos)
+        {
+            word_ = {};
+            return;
+        }
+        word_ = text_.substr(pos, text_.find(' ', pos) - pos);
+    }
+};
+
+//       range-based for
+class WordRange {
+public:
+    explicit WordRange(const std::string_view text)
+        : text_(text) {
+
+    }
+
+    WordIterator begin() const {
+        return WordIterator(text_);
+    }
+
+    WordIterator end() const {
+        return {};
+    }
+
+    bool empty() const {
+        return begin() == end();
+    }
+
+private:
+    std::string_view text_;
+};
+
+// ,    ,    
+template <typename Iterator, typename Predicate>
+class FilterIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+    using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+    using pointer = typename std::iterator_traits<Iterator>::pointer;
+    using reference = typename std::iterator_traits<Iterator>::reference;
+
+    FilterIterator(Iterator current, Iterator end, Predicate predicate)
+        : current_(current), end_(end), predicate_(predicate) {
+        SkipRejected();
+    }
+
+    reference operator*() const {
+        return *current_;
+    }
+
+    pointer operator->() const {
+        return current_.operator->();
+    }
+
+    FilterIterator& operator++() {
+        ++current_;
+        SkipRejected();
+        return *this;
+    }
+
+    FilterIterator operator++(int) {
+        FilterIterator prev = *this;
+        ++(*this);
+        return prev;
+    }
+
+    friend bool operator==(const FilterIterator& lhs, const FilterIterator& rhs) {
+        return lhs.current_ == rhs.current_;
+    }
+
+    friend bool operator!=(const FilterIterator& lhs, const FilterIterator& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    Iterator current_;
+    Iterator end_;
+    Predicate predicate_;
+
+    void SkipRejected() {
+        while (current_ != end_ && !predicate_(*current_))
+        {
+            ++current_;
+        }
+    }
+};
+
+template <typename Iterator, typename Predicate>
+class FilteredRange {
+public:
+    FilteredRange(Iterator begin, Iterator end, Predicate predicate)
+        : begin_(begin), end_(end), predicate_(predicate) {
+
+    }
+
+    FilterIterator<Iterator, Predicate> begin() const {
+        return { begin_, end_, predicate_ };
+    }
+
+    FilterIterator<Iterator, Predicate> end() const {
+        return { end_, end_, predicate_ };
+    }
+
+    bool empty() const {
+        return begin() == end();
+    }
+
+private:
+    Iterator begin_;
+    Iterator end_;
+    Predicate predicate_;
+};
+
+//     ,  
+template <typename Range, typename Predicate>
+auto FilterWords(const Range& range, Predicate predicate) {
+    return FilteredRange<decltype(range.begin()), Predicate>(range.begin(), range.end(), predicate);
+}
+
+//   (string_view)       
+WordRange SplitIntoWords(const std::string_view text);
 
 template <typename StringContainer>
 std::set<std::string, std::less<>> MakeUniqueNonEmptyStrings(const StringContainer& strings) {
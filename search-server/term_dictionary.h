@@ -0,0 +1,521 @@
+#pragma once
+
+#include "memory_stats.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ *   -    (radix trie)     .
+ *
+ *        ;     ,
+ *     [ ,  )     .
+ *        ,   ,  
+ *  ,       O(  +  ).
+ *
+ *    ,    ,     
+ *  string_view.        ;
+ *      .
+ *
+ *  TermDictionary<int> dictionary;
+ *  dictionary.Insert("curly"sv).first.value = 1;
+ *  dictionary.ForEachWithPrefix("cur"sv, [](string_view term, int value) { ... });
+ *  dictionary.ForEachWithinDistance("curlu"sv, 1, [](string_view term, uint32_t distance, int value) { ... });
+ */
+template <typename Value>
+class TermDictionary {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    //     
+    struct TermEntry {
+        std::string_view term;
+        Value& value;
+    };
+
+    explicit TermDictionary(const allocator_type& alloc = {})
+        : nodes_(alloc), entry_chunks_(alloc), free_nodes_(alloc), free_entries_(alloc), erase_path_(alloc) {
+        nodes_.emplace_back();
+    }
+
+    size_t GetTermsCount() const {
+        return terms_count_;
+    }
+
+    //  ; nullptr,   
+    Value* Find(std::string_view term) {
+        const uint32_t node = FindNode(term);
+        return node == NONE || nodes_[node].term == NONE ? nullptr : &GetEntry(nodes_[node].term).value;
+    }
+
+    const Value* Find(std::string_view term) const {
+        const uint32_t node = FindNode(term);
+        return node == NONE || nodes_[node].term == NONE ? nullptr : &GetEntry(nodes_[node].term).value;
+    }
+
+    //  ,   ; second -  
+    std::pair<TermEntry, bool> Insert(std::string_view term);
+
+    //     ; false,   
+    bool Erase(std::string_view term);
+
+    // callback(term, value)   ,   prefix,   
+    template <typename Callback>
+    void ForEachWithPrefix(std::string_view prefix, Callback callback) const;
+
+    // callback(term, distance, value)       distance <= max_distance
+    //  word;         (  ),
+    //  ,     max_distance,  
+    template <typename Callback>
+    void ForEachWithinDistance(std::string_view word, uint32_t max_distance, Callback callback) const;
+
+    //     ; ,   ,  
+    size_t GetMemoryUsage() const {
+        return nodes_.capacity() * sizeof(Node) + entry_chunks_.capacity() * sizeof(EntryChunk)
+            + entry_chunks_.size() * ENTRY_CHUNK_SIZE * sizeof(Entry) + terms_heap_size_
+            + (free_nodes_.capacity() + free_entries_.capacity() + erase_path_.capacity()) * sizeof(uint32_t);
+    }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr uint32_t ROOT = 0;
+
+    struct Node {
+        //    :  [label_begin, label_end)  label_term
+        uint32_t label_term = NONE;
+        uint32_t label_begin = 0;
+        uint32_t label_end = 0;
+        uint32_t first_child = NONE;
+        //      
+        uint32_t next_sibling = NONE;
+        // ,   
+        uint32_t term = NONE;
+    };
+
+    //    ,   ;      - 
+    template <typename... Args>
+    static Value MakeValue(const allocator_type& alloc, Args&&... args) {
+        if constexpr (std::uses_allocator_v<Value, allocator_type>)
+        {
+            return Value(std::forward<Args>(args)..., alloc);
+        }
+        else
+        {
+            return Value(std::forward<Args>(args)...);
+        }
+    }
+
+    struct Entry {
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        explicit Entry(const allocator_type& alloc)
+            : text(alloc), value(MakeValue(alloc)) {
+        }
+
+        Entry(const Entry& other, const allocator_type& alloc)
+            : text(other.text, alloc), value(MakeValue(alloc, other.value)) {
+        }
+
+        Entry(Entry&& other, const allocator_type& alloc)
+            : text(std::move(other.text), alloc), value(MakeValue(alloc, std::move(other.value))) {
+        }
+
+        std::pmr::string text;
+        Value value;
+    };
+
+    //           
+    using EntryChunk = std::pmr::vector<Entry>;
+    static constexpr uint32_t ENTRY_CHUNK_SIZE = 256;
+
+    std::pmr::vector<Node> nodes_;
+    //   
+    std::pmr::vector<EntryChunk> entry_chunks_;
+    uint32_t entries_count_ = 0;
+    std::pmr::vector<uint32_t> free_nodes_;
+    std::pmr::vector<uint32_t> free_entries_;
+    //     ;    Erase
+    std::pmr::vector<uint32_t> erase_path_;
+
+    size_t terms_count_ = 0;
+    //   ,      
+    size_t terms_heap_size_ = 0;
+
+private:
+    Entry& GetEntry(uint32_t entry) {
+        return entry_chunks_[entry / ENTRY_CHUNK_SIZE][entry % ENTRY_CHUNK_SIZE];
+    }
+
+    const Entry& GetEntry(uint32_t entry) const {
+        return entry_chunks_[entry / ENTRY_CHUNK_SIZE][entry % ENTRY_CHUNK_SIZE];
+    }
+
+    std::string_view GetLabel(const Node& node) const {
+        return std::string_view(GetEntry(node.label_term).text).substr(node.label_begin, node.label_end - node.label_begin);
+    }
+
+    unsigned char GetFirstChar(uint32_t node) const {
+        return static_cast<unsigned char>(GetEntry(nodes_[node].label_term).text[nodes_[node].label_begin]);
+    }
+
+    //  ,      c
+    uint32_t FindChild(uint32_t node, char c) const {
+        const unsigned char first_char = static_cast<unsigned char>(c);
+        for (uint32_t child = nodes_[node].first_child; child != NONE; child = nodes_[child].next_sibling) {
+            const unsigned char child_char = GetFirstChar(child);
+            if (child_char >= first_char)
+            {
+                return child_char == first_char ? child : NONE;
+            }
+        }
+        return NONE;
+    }
+
+    // ,     term; NONE,        
+    uint32_t FindNode(std::string_view term) const {
+        uint32_t node = ROOT;
+        size_t depth = 0;
+        while (depth < term.size()) {
+            const uint32_t child = FindChild(node, term[depth]);
+            if (child == NONE)
+            {
+                return NONE;
+            }
+            const std::string_view label = GetLabel(nodes_[child]);
+            if (term.compare(depth, label.size(), label) != 0)
+            {
+                return NONE;
+            }
+            depth += label.size();
+            node = child;
+        }
+        return node;
+    }
+
+    //     ;     
+    uint32_t FindAnyTerm(uint32_t node) const {
+        while (nodes_[node].term == NONE) {
+            node = nodes_[node].first_child;
+        }
+        return nodes_[node].term;
+    }
+
+    //     parent  child  replacement (NONE -  child)
+    void ReplaceChild(uint32_t parent, uint32_t child, uint32_t replacement) {
+        uint32_t* link = &nodes_[parent].first_child;
+        while (*link != child) {
+            link = &nodes_[*link].next_sibling;
+        }
+        *link = replacement == NONE ? nodes_[child].next_sibling : replacement;
+    }
+
+    uint32_t AllocateNode() {
+        if (!free_nodes_.empty())
+        {
+            const uint32_t node = free_nodes_.back();
+            free_nodes_.pop_back();
+            return node;
+        }
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void FreeNode(uint32_t node) {
+        nodes_[node] = Node();
+        free_nodes_.push_back(node);
+    }
+
+    uint32_t AllocateEntry(std::string_view term);
+
+    void FreeEntry(uint32_t entry);
+
+    template <typename Callback>
+    void ForEachInSubtree(uint32_t node, Callback& callback) const;
+
+    // rows -         node,  word.size() + 1  
+    template <typename Callback>
+    void ForEachWithinDistance(uint32_t node, std::string_view word, uint32_t max_distance,
+        std::vector<uint32_t>& rows, Callback& callback) const;
+};
+
+template <typename Value>
+std::pair<typename TermDictionary<Value>::TermEntry, bool> TermDictionary<Value>::Insert(std::string_view term) {
+
+    uint32_t node = ROOT;
+    uint32_t depth = 0;
+    while (depth < term.size()) {
+        //             
+        const unsigned char first_char = static_cast<unsigned char>(term[depth]);
+        uint32_t previous = NONE;
+        uint32_t child = nodes_[node].first_child;
+        while (child != NONE && GetFirstChar(child) < first_char) {
+            previous = child;
+            child = nodes_[child].next_sibling;
+        }
+
+        if (child == NONE || GetFirstChar(child) != first_char)
+        {
+            //      
+            const uint32_t entry = AllocateEntry(term);
+            const uint32_t leaf = AllocateNode();
+            nodes_[leaf] = { entry, depth, static_cast<uint32_t>(term.size()), NONE, child, entry };
+            if (previous == NONE)
+            {
+                nodes_[node].first_child = leaf;
+            }
+            else
+            {
+                nodes_[previous].next_sibling = leaf;
+            }
+            return { { GetEntry(entry).text, GetEntry(entry).value }, true };
+        }
+
+        const std::string_view label = GetLabel(nodes_[child]);
+        const size_t max_common = std::min(label.size(), term.size() - depth);
+        uint32_t common = 0;
+        while (common < max_common && label[common] == term[depth + common]) {
+            ++common;
+        }
+
+        if (common < label.size())
+        {
+            //    :      
+            const uint32_t middle = AllocateNode();
+            const Node child_node = nodes_[child];
+            nodes_[middle] = { child_node.label_term, child_node.label_begin, depth + common, child, child_node.next_sibling, NONE };
+            nodes_[child].label_begin = depth + common;
+            nodes_[child].next_sibling = NONE;
+            if (previous == NONE)
+            {
+                nodes_[node].first_child = middle;
+            }
+            else
+            {
+                nodes_[previous].next_sibling = middle;
+            }
+            child = middle;
+        }
+
+        node = child;
+        depth += common;
+    }
+
+    if (nodes_[node].term != NONE)
+    {
+        const uint32_t entry = nodes_[node].term;
+        return { { GetEntry(entry).text, GetEntry(entry).value }, false };
+    }
+
+    const uint32_t entry = AllocateEntry(term);
+    nodes_[node].term = entry;
+    return { { GetEntry(entry).text, GetEntry(entry).value }, true };
+}
+
+template <typename Value>
+bool TermDictionary<Value>::Erase(std::string_view term) {
+
+    erase_path_.clear();
+    erase_path_.push_back(ROOT);
+    size_t depth = 0;
+    while (depth < term.size()) {
+        const uint32_t child = FindChild(erase_path_.back(), term[depth]);
+        if (child == NONE)
+        {
+            return false;
+        }
+        const std::string_view label = GetLabel(nodes_[child]);
+        if (term.compare(depth, label.size(), label) != 0)
+        {
+            return false;
+        }
+        depth += label.size();
+        erase_path_.push_back(child);
+    }
+
+    const uint32_t entry = nodes_[erase_path_.back()].term;
+    if (entry == NONE)
+    {
+        return false;
+    }
+    nodes_[erase_path_.back()].term = NONE;
+
+    //    ,         ;
+    //         
+    for (size_t i = erase_path_.size() - 1; i > 0; --i) {
+        const uint32_t node = erase_path_[i];
+        const uint32_t parent = erase_path_[i - 1];
+        if (nodes_[node].term != NONE)
+        {
+            break;
+        }
+        const uint32_t child = nodes_[node].first_child;
+        if (child == NONE)
+        {
+            ReplaceChild(parent, node, NONE);
+            FreeNode(node);
+            continue;
+        }
+        if (nodes_[child].next_sibling == NONE)
+        {
+            nodes_[child].label_begin = nodes_[node].label_begin;
+            nodes_[child].next_sibling = nodes_[node].next_sibling;
+            ReplaceChild(parent, node, child);
+            FreeNode(node);
+        }
+        break;
+    }
+
+    //   ,     ,      
+    const std::string_view text = GetEntry(entry).text;
+    uint32_t node = ROOT;
+    depth = 0;
+    while (depth < text.size()) {
+        const uint32_t child = FindChild(node, text[depth]);
+        if (child == NONE)
+        {
+            break;
+        }
+        if (nodes_[child].label_term == entry)
+        {
+            nodes_[child].label_term = FindAnyTerm(child);
+        }
+        depth = nodes_[child].label_end;
+        node = child;
+    }
+
+    FreeEntry(entry);
+    return true;
+}
+
+template <typename Value>
+template <typename Callback>
+void TermDictionary<Value>::ForEachWithPrefix(std::string_view prefix, Callback callback) const {
+
+    uint32_t node = ROOT;
+    size_t depth = 0;
+    while (depth < prefix.size()) {
+        const uint32_t child = FindChild(node, prefix[depth]);
+        if (child == NONE)
+        {
+            return;
+        }
+        //     
+        const std::string_view label = GetLabel(nodes_[child]);
+        const size_t length = std::min(label.size(), prefix.size() - depth);
+        if (prefix.compare(depth, length, label.substr(0, length)) != 0)
+        {
+            return;
+        }
+        depth += label.size();
+        node = child;
+    }
+
+    ForEachInSubtree(node, callback);
+}
+
+template <typename Value>
+template <typename Callback>
+void TermDictionary<Value>::ForEachInSubtree(uint32_t node, Callback& callback) const {
+    if (nodes_[node].term != NONE)
+    {
+        const Entry& entry = GetEntry(nodes_[node].term);
+        callback(std::string_view(entry.text), entry.value);
+    }
+    for (uint32_t child = nodes_[node].first_child; child != NONE; child = nodes_[child].next_sibling) {
+        ForEachInSubtree(child, callback);
+    }
+}
+
+template <typename Value>
+template <typename Callback>
+void TermDictionary<Value>::ForEachWithinDistance(std::string_view word, uint32_t max_distance, Callback callback) const {
+    //   :    word   
+    std::vector<uint32_t> rows(word.size() + 1);
+    std::iota(rows.begin(), rows.end(), 0u);
+    ForEachWithinDistance(ROOT, word, max_distance, rows, callback);
+}
+
+template <typename Value>
+template <typename Callback>
+void TermDictionary<Value>::ForEachWithinDistance(uint32_t node, std::string_view word, uint32_t max_distance,
+    std::vector<uint32_t>& rows, Callback& callback) const {
+
+    const size_t width = word.size() + 1;
+    if (nodes_[node].term != NONE && rows.back() <= max_distance)
+    {
+        const Entry& entry = GetEntry(nodes_[node].term);
+        callback(std::string_view(entry.text), rows.back(), entry.value);
+    }
+
+    for (uint32_t child = nodes_[node].first_child; child != NONE; child = nodes_[child].next_sibling) {
+        const std::string_view label = GetLabel(nodes_[child]);
+        size_t added_rows = 0;
+        bool reachable = true;
+        for (const char c : label) {
+            rows.resize(rows.size() + width);
+            ++added_rows;
+            const uint32_t* previous = rows.data() + rows.size() - 2 * width;
+            uint32_t* current = rows.data() + rows.size() - width;
+
+            current[0] = previous[0] + 1;
+            uint32_t row_min = current[0];
+            for (size_t i = 1; i < width; ++i) {
+                current[i] = std::min({ previous[i] + 1, current[i - 1] + 1, previous[i - 1] + (word[i - 1] == c ? 0u : 1u) });
+                row_min = std::min(row_min, current[i]);
+            }
+            //     
+            if (row_min > max_distance)
+            {
+                reachable = false;
+                break;
+            }
+        }
+        if (reachable)
+        {
+            ForEachWithinDistance(child, word, max_distance, rows, callback);
+        }
+        rows.resize(rows.size() - added_rows * width);
+    }
+}
+
+template <typename Value>
+uint32_t TermDictionary<Value>::AllocateEntry(std::string_view term) {
+    uint32_t entry = 0;
+    if (!free_entries_.empty())
+    {
+        entry = free_entries_.back();
+        free_entries_.pop_back();
+    }
+    else
+    {
+        if (entries_count_ % ENTRY_CHUNK_SIZE == 0)
+        {
+            entry_chunks_.emplace_back().reserve(ENTRY_CHUNK_SIZE);
+        }
+        entry_chunks_.back().emplace_back();
+        entry = entries_count_++;
+    }
+
+    GetEntry(entry).text.assign(term.begin(), term.end());
+    terms_heap_size_ += GetStringHeapSize(GetEntry(entry).text);
+    ++terms_count_;
+    return entry;
+}
+
+template <typename Value>
+void TermDictionary<Value>::FreeEntry(uint32_t entry) {
+    Entry& freed = GetEntry(entry);
+    terms_heap_size_ -= GetStringHeapSize(freed.text);
+    freed.text.clear();
+    freed.text.shrink_to_fit();
+    freed.value = MakeValue(nodes_.get_allocator());
+    free_entries_.push_back(entry);
+    --terms_count_;
+}
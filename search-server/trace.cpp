@@ -0,0 +1,326 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+//           Chrome trace;
+//       
+static const size_t MAX_TRACE_EVENTS_PER_THREAD = 1u << 20;
+
+//     :   -
+//      ,    
+struct TraceDurations {
+    array<atomic<uint64_t>, LatencyHistogram::BUCKETS_COUNT> counts{};
+    atomic<uint64_t> max_ns{ 0 };
+
+    void Record(LatencyHistogram::Duration duration) {
+        atomic<uint64_t>& count = counts[LatencyHistogram::GetBucketIndex(duration)];
+        count.store(count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        const uint64_t value = static_cast<uint64_t>(max<LatencyHistogram::Duration::rep>(duration.count(), 0));
+        if (value > max_ns.load(memory_order_relaxed))
+        {
+            max_ns.store(value, memory_order_relaxed);
+        }
+    }
+
+    void AddTo(LatencyHistogram& histogram) const {
+        const LatencyHistogram::Duration max_duration(max_ns.load(memory_order_relaxed));
+        for (size_t i = 0; i < counts.size(); ++i) {
+            histogram.AddBucketCount(i, counts[i].load(memory_order_relaxed), max_duration);
+        }
+    }
+
+    void Clear() {
+        for (auto& count : counts) {
+            count.store(0, memory_order_relaxed);
+        }
+        max_ns.store(0, memory_order_relaxed);
+    }
+};
+
+//    :     
+struct TraceNode {
+    TraceNode(size_t site_id, int parent)
+        : site_id(site_id), parent(parent) {
+    }
+
+    size_t site_id;
+    int parent;
+    TraceDurations durations;
+};
+
+struct TraceEvent {
+    int node;
+    TraceSpan::Clock::time_point start_time;
+    TraceSpan::Clock::duration duration;
+};
+
+//   :   ,    
+struct RetiredTraceEvent {
+    size_t thread_index;
+    size_t site_id;
+    TraceSpan::Clock::time_point start_time;
+    TraceSpan::Clock::duration duration;
+};
+
+struct ThreadTrace {
+    size_t thread_index = 0;
+
+    //    ; -1 -  
+    int current_node = -1;
+
+    //           ;
+    //     . deque     
+    mutex data_mutex;
+    deque<TraceNode> nodes;
+    vector<TraceEvent> events;
+
+    int FindOrAddNode(int parent, size_t site_id) {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].parent == parent && nodes[i].site_id == site_id)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        lock_guard guard(data_mutex);
+        nodes.emplace_back(site_id, parent);
+        return static_cast<int>(nodes.size() - 1);
+    }
+};
+
+//   ,       ;
+//    registry_mutex,       
+struct TraceRegistry {
+    mutex registry_mutex;
+    vector<string> site_names;
+    vector<unique_ptr<ThreadTrace>> threads;
+    size_t next_thread_index = 0;
+    map<string, LatencyHistogram> retired_histograms;
+    vector<RetiredTraceEvent> retired_events;
+    atomic<bool> events_recording{ false };
+};
+
+static TraceRegistry& GetTraceRegistry() {
+    static TraceRegistry registry;
+    return registry;
+}
+
+//    :     '/'
+static string GetNodePath(const deque<TraceNode>& nodes, int node, const vector<string>& site_names) {
+    string path = site_names[nodes[node].site_id];
+    for (int parent = nodes[node].parent; parent != -1; parent = nodes[parent].parent) {
+        path = site_names[nodes[parent].site_id] + '/' + path;
+    }
+    return path;
+}
+
+//          ,    
+class ThreadTraceOwner {
+public:
+    ThreadTraceOwner() {
+        auto thread_trace = make_unique<ThreadTrace>();
+        thread_trace_ = thread_trace.get();
+        TraceRegistry& registry = GetTraceRegistry();
+        lock_guard guard(registry.registry_mutex);
+        thread_trace->thread_index = registry.next_thread_index++;
+        registry.threads.push_back(move(thread_trace));
+    }
+
+    ThreadTraceOwner(const ThreadTraceOwner&) = delete;
+    ThreadTraceOwner& operator=(const ThreadTraceOwner&) = delete;
+
+    //    thread_local-,  ,  
+    ~ThreadTraceOwner() {
+        TraceRegistry& registry = GetTraceRegistry();
+        lock_guard guard(registry.registry_mutex);
+        for (size_t node = 0; node < thread_trace_->nodes.size(); ++node) {
+            thread_trace_->nodes[node].durations.AddTo(registry.retired_histograms[
+                GetNodePath(thread_trace_->nodes, static_cast<int>(node), registry.site_names)]);
+        }
+        for (const TraceEvent& event : thread_trace_->events) {
+            if (registry.retired_events.size() == MAX_TRACE_EVENTS_PER_THREAD)
+            {
+                break;
+            }
+            registry.retired_events.push_back({ thread_trace_->thread_index,
+                thread_trace_->nodes[event.node].site_id, event.start_time, event.duration });
+        }
+        const auto thread_it = find_if(registry.threads.begin(), registry.threads.end(),
+            [this](const unique_ptr<ThreadTrace>& thread_trace) { return thread_trace.get() == thread_trace_; });
+        registry.threads.erase(thread_it);
+    }
+
+    ThreadTrace& Get() const {
+        return *thread_trace_;
+    }
+
+private:
+    ThreadTrace* thread_trace_;
+};
+
+static ThreadTrace& GetThreadTrace() {
+    thread_local const ThreadTraceOwner owner;
+    return owner.Get();
+}
+
+TraceSite::TraceSite(string_view name) {
+    TraceRegistry& registry = GetTraceRegistry();
+    lock_guard guard(registry.registry_mutex);
+    id_ = registry.site_names.size();
+    registry.site_names.emplace_back(name);
+}
+
+TraceSpan::TraceSpan(const TraceSite& site, TraceSiteCache& cache) {
+    if (!cache.thread_trace)
+    {
+        cache.thread_trace = &GetThreadTrace();
+    }
+    thread_trace_ = cache.thread_trace;
+    parent_node_ = thread_trace_->current_node;
+    if (cache.node == -1 || cache.parent_node != parent_node_)
+    {
+        cache.node = thread_trace_->FindOrAddNode(parent_node_, site.GetId());
+        cache.parent_node = parent_node_;
+    }
+    node_ = cache.node;
+    thread_trace_->current_node = node_;
+}
+
+TraceSpan::~TraceSpan() {
+    const auto duration = Clock::now() - start_time_;
+    thread_trace_->nodes[node_].durations.Record(duration);
+    if (GetTraceRegistry().events_recording.load(memory_order_relaxed))
+    {
+        lock_guard guard(thread_trace_->data_mutex);
+        if (thread_trace_->events.size() < MAX_TRACE_EVENTS_PER_THREAD)
+        {
+            thread_trace_->events.push_back({ node_, start_time_, duration });
+        }
+    }
+    thread_trace_->current_node = parent_node_;
+}
+
+map<string, LatencyHistogram> CollectTraceHistograms() {
+    TraceRegistry& registry = GetTraceRegistry();
+    lock_guard registry_guard(registry.registry_mutex);
+    map<string, LatencyHistogram> result = registry.retired_histograms;
+
+    for (const auto& thread_trace : registry.threads) {
+        lock_guard guard(thread_trace->data_mutex);
+        for (size_t node = 0; node < thread_trace->nodes.size(); ++node) {
+            thread_trace->nodes[node].durations.AddTo(
+                result[GetNodePath(thread_trace->nodes, static_cast<int>(node), registry.site_names)]);
+        }
+    }
+
+    return result;
+}
+
+void ResetTraceData() {
+    TraceRegistry& registry = GetTraceRegistry();
+    lock_guard registry_guard(registry.registry_mutex);
+    registry.retired_histograms.clear();
+    registry.retired_events.clear();
+    for (const auto& thread_trace : registry.threads) {
+        lock_guard guard(thread_trace->data_mutex);
+        for (TraceNode& node : thread_trace->nodes) {
+            node.durations.Clear();
+        }
+        thread_trace->events.clear();
+    }
+}
+
+void SetTraceEventsRecording(bool enabled) {
+    GetTraceRegistry().events_recording.store(enabled);
+}
+
+static void WriteJsonString(ostream& output, string_view text) {
+    output << '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\')
+        {
+            output << '\\';
+        }
+        output << c;
+    }
+    output << '"';
+}
+
+void WriteTraceSummary(ostream& output) {
+    output << '[';
+    bool is_first = true;
+    for (const auto& [path, durations] : CollectTraceHistograms()) {
+        if (durations.GetTotalCount() == 0)
+        {
+            continue;
+        }
+        output << (is_first ? "\n" : ",\n") << "  {\"path\": ";
+        WriteJsonString(output, path);
+        output << ", \"count\": " << durations.GetTotalCount()
+            << ", \"p50_ns\": " << durations.GetPercentile(0.5).count()
+            << ", \"p90_ns\": " << durations.GetPercentile(0.9).count()
+            << ", \"p99_ns\": " << durations.GetPercentile(0.99).count()
+            << ", \"max_ns\": " << durations.GetMax().count() << '}';
+        is_first = false;
+    }
+    output << "\n]";
+}
+
+void WriteChromeTrace(ostream& output) {
+    using namespace chrono;
+
+    const auto flags = output.flags();
+    const auto precision = output.precision();
+    output << fixed << setprecision(3);
+
+    output << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool is_first = true;
+    const auto write_event = [&](string_view name, size_t thread_index,
+        TraceSpan::Clock::time_point start_time, TraceSpan::Clock::duration event_duration) {
+        output << (is_first ? "\n" : ",\n") << "  {\"name\": ";
+        WriteJsonString(output, name);
+        output << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << thread_index
+            << ", \"ts\": " << duration<double, micro>(start_time.time_since_epoch()).count()
+            << ", \"dur\": " << duration<double, micro>(event_duration).count() << '}';
+        is_first = false;
+    };
+    {
+        TraceRegistry& registry = GetTraceRegistry();
+        lock_guard registry_guard(registry.registry_mutex);
+        for (const RetiredTraceEvent& event : registry.retired_events) {
+            write_event(registry.site_names[event.site_id], event.thread_index, event.start_time, event.duration);
+        }
+        for (const auto& thread_trace : registry.threads) {
+            lock_guard guard(thread_trace->data_mutex);
+            for (const TraceEvent& event : thread_trace->events) {
+                write_event(registry.site_names[thread_trace->nodes[event.node].site_id],
+                    thread_trace->thread_index, event.start_time, event.duration);
+            }
+        }
+    }
+    output.flags(flags);
+    output.precision(precision);
+
+    output << "\n], \"summary\": ";
+    WriteTraceSummary(output);
+    output << "}\n";
+}
+
+void ExportTrace(const string& file_name) {
+    ofstream output(file_name);
+    if (!output)
+    {
+        throw runtime_error("Cannot open trace file "s + file_name);
+    }
+    WriteChromeTrace(output);
+}
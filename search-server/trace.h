@@ -0,0 +1,103 @@
+#pragma once
+
+#include "latency_histogram.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#define TRACE_CONCAT_INTERNAL(X, Y) X##Y
+#define TRACE_CONCAT(X, Y) TRACE_CONCAT_INTERNAL(X, Y)
+
+/**
+ *             .
+ *    :    
+ *      "FindTopDocuments/ParseQuery".
+ *
+ *           ;  
+ *      ,  -     ,
+ *    :
+ *
+ *  void FindSomething() {
+ *      TRACE_SPAN("FindSomething");
+ *      {
+ *          TRACE_SPAN("Stage");
+ *          ...
+ *      }
+ *  }
+ *
+ *  WriteTraceSummary(std::cout);   //       JSON
+ *
+ *    SEARCH_SERVER_NO_TRACING     .
+ */
+#ifdef SEARCH_SERVER_NO_TRACING
+#define TRACE_SPAN(name)
+#else
+#define TRACE_SPAN(name) \
+    static const TraceSite TRACE_CONCAT(traceSite, __LINE__)(name); \
+    static thread_local TraceSiteCache TRACE_CONCAT(traceSiteCache, __LINE__); \
+    TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(TRACE_CONCAT(traceSite, __LINE__), TRACE_CONCAT(traceSiteCache, __LINE__))
+#endif
+
+//   ,    ;   
+class TraceSite {
+public:
+    explicit TraceSite(std::string_view name);
+
+    size_t GetId() const {
+        return id_;
+    }
+
+private:
+    size_t id_;
+};
+
+struct ThreadTrace;
+
+// ,          :
+//           
+struct TraceSiteCache {
+    ThreadTrace* thread_trace = nullptr;
+    int parent_node = -1;
+    int node = -1;
+};
+
+class TraceSpan {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TraceSpan(const TraceSite& site, TraceSiteCache& cache);
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    ~TraceSpan();
+
+private:
+    ThreadTrace* thread_trace_;
+    int node_;
+    int parent_node_;
+    const Clock::time_point start_time_ = Clock::now();
+};
+
+//     :   -> 
+std::map<std::string, LatencyHistogram> CollectTraceHistograms();
+
+//       ;
+// ,    ,   
+void ResetTraceData();
+
+//         Chrome trace (  )
+void SetTraceEventsRecording(bool enabled);
+
+//    JSON:     , p50, p90, p99    
+void WriteTraceSummary(std::ostream& output);
+
+//     Chrome trace (chrome://tracing, Perfetto)
+void WriteChromeTrace(std::ostream& output);
+
+//        Chrome trace    
+void ExportTrace(const std::string& file_name);